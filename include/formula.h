@@ -0,0 +1,394 @@
+/**
+ * @file formula.h
+ * @brief Inline complex arithmetic and the formula kernel generator
+ *
+ * @details Included by the translation units that iterate formulas. The
+ * complex helpers are defined here so every kernel expanded by
+ * FORMULA_KERNELS is fully inlined: no call, direct or indirect, is left
+ * inside the iteration loop.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#ifndef FORMULA_H
+# define FORMULA_H
+
+# include "fract_ol.h"
+
+/**
+ * @def FORMULA_INLINE
+ * @brief Forces a helper into every kernel that uses it
+ *
+ * @details The compiler's own heuristics leave large helpers such as the
+ * fast transcendentals out of line, which would keep a call and the tier
+ * test inside the iteration loop.
+ *
+ * @ingroup fractal_render
+ */
+# define FORMULA_INLINE	static inline __attribute__((always_inline))
+
+/**
+ * @brief Inline product of two complex numbers
+ *
+ * @ingroup complex_ops
+ *
+ * @param[in] a First factor
+ * @param[in] b Second factor
+ *
+ * @return t_complex a * b
+ */
+static inline t_complex	cx_mul(t_complex a, t_complex b)
+{
+	t_complex	result;
+
+	result.real = (a.real * b.real) - (a.imag * b.imag);
+	result.imag = (a.real * b.imag) + (a.imag * b.real);
+	return (result);
+}
+
+/**
+ * @brief Inline sum of two complex numbers
+ *
+ * @ingroup complex_ops
+ *
+ * @param[in] a First term
+ * @param[in] b Second term
+ *
+ * @return t_complex a + b
+ */
+static inline t_complex	cx_add(t_complex a, t_complex b)
+{
+	t_complex	result;
+
+	result.real = a.real + b.real;
+	result.imag = a.imag + b.imag;
+	return (result);
+}
+
+/**
+ * @brief Inline quotient of two complex numbers
+ *
+ * @ingroup complex_ops
+ *
+ * @param[in] a Dividend
+ * @param[in] b Divisor
+ *
+ * @return t_complex a / b
+ */
+static inline t_complex	cx_div(t_complex a, t_complex b)
+{
+	t_complex	result;
+	double		den;
+
+	den = (b.real * b.real) + (b.imag * b.imag);
+	result.real = (a.real * b.real + a.imag * b.imag) / den;
+	result.imag = (a.imag * b.real - a.real * b.imag) / den;
+	return (result);
+}
+
+/**
+ * @brief Inline reciprocal of a complex number
+ *
+ * @ingroup complex_ops
+ *
+ * @param[in] a Number to invert
+ *
+ * @return t_complex 1 / a
+ */
+static inline t_complex	cx_inv(t_complex a)
+{
+	t_complex	result;
+	double		den;
+
+	den = (a.real * a.real) + (a.imag * a.imag);
+	result.real = a.real / den;
+	result.imag = -a.imag / den;
+	return (result);
+}
+
+/**
+ * @brief Inline hyperbolic sine of a complex number
+ *
+ * @ingroup complex_ops
+ *
+ * @param[in] num Argument
+ *
+ * @return t_complex sinh(num)
+ */
+static inline t_complex	cx_sinh(t_complex num)
+{
+	t_complex	result;
+
+	result.real = sinh(num.real) * cos(num.imag);
+	result.imag = cosh(num.real) * sin(num.imag);
+	return (result);
+}
+
+/**
+ * @brief Fused fast hyperbolic sine and cosine for the preview tier
+ *
+ * @details Reduces x to r = x - k ln2 with |r| <= ln2 / 2 and splits the
+ * degree 9 Taylor polynomial of e^r into its even part E and odd part O, so
+ * e^x = 2^k (E + O) and e^-x = 2^-k (E - O) come from one evaluation, without
+ * the division by e^x. 2^k and 2^-k are built straight in the exponent
+ * bits. Relative error stays below 1e-10; arguments beyond 708, infinities
+ * and NaN go to the C library.
+ *
+ * @ingroup complex_ops
+ *
+ * @param[in] x Argument
+ * @param[out] sh sinh(x)
+ * @param[out] ch cosh(x)
+ */
+FORMULA_INLINE void	fast_sinhcosh(double x, double *sh, double *ch)
+{
+	double	k;
+	double	r;
+	double	r2;
+	double	even;
+	double	odd;
+	double	scale[2];
+	Uint64	bits[2];
+
+	if (!(fabs(x) < 708.0))
+	{
+		*sh = sinh(x);
+		*ch = cosh(x);
+		return ;
+	}
+	k = (x * 1.44269504088896340736 + 0x1.8p52) - 0x1.8p52;
+	r = (x - k * 6.93147180369123816490e-01) - k * 1.90821492927058770002e-10;
+	r2 = r * r;
+	even = 1.0 + r2 * (0.5 + r2 * (1.0 / 24 + r2 * (1.0 / 720 + r2
+					* (1.0 / 40320))));
+	odd = r * (1.0 + r2 * (1.0 / 6 + r2 * (1.0 / 120 + r2 * (1.0 / 5040
+						+ r2 * (1.0 / 362880)))));
+	bits[0] = (Uint64)(1023 + (long)k) << 52;
+	bits[1] = (Uint64)(1023 - (long)k) << 52;
+	memcpy(scale, bits, sizeof(scale));
+	*sh = 0.5 * (scale[0] * (even + odd) - scale[1] * (even - odd));
+	*ch = 0.5 * (scale[0] * (even + odd) + scale[1] * (even - odd));
+}
+
+/**
+ * @brief Fused fast sine and cosine for the preview tier
+ *
+ * @details One range reduction r = x - q pi/2 with |r| <= pi/4, pi/2 split in
+ * two parts, then degree 11 and 12 Taylor polynomials of sin r and cos r
+ * rotated by the quadrant through a table, without branches. Absolute error
+ * stays below 1e-11; arguments beyond 1e6, infinities and NaN go to the C
+ * library.
+ *
+ * @ingroup complex_ops
+ *
+ * @param[in] x Argument
+ * @param[out] sn sin(x)
+ * @param[out] cs cos(x)
+ */
+FORMULA_INLINE void	fast_sincos(double x, double *sn, double *cs)
+{
+	static const double	quadrant[5] = {0, 1, 0, -1, 0};
+	double				k;
+	double				r;
+	double				r2;
+	double				s;
+	double				c;
+
+	if (!(fabs(x) < 1e6))
+	{
+		*sn = sin(x);
+		*cs = cos(x);
+		return ;
+	}
+	k = (x * 6.36619772367581382433e-01 + 0x1.8p52) - 0x1.8p52;
+	r = (x - k * 1.57079632673412561417e+00) - k * 6.07710050650619224932e-11;
+	r2 = r * r;
+	s = r * (1.0 - r2 * (1.0 / 6 - r2 * (1.0 / 120 - r2 * (1.0 / 5040
+						- r2 * (1.0 / 362880 - r2 * (1.0 / 39916800))))));
+	c = 1.0 - r2 * (0.5 - r2 * (1.0 / 24 - r2 * (1.0 / 720 - r2
+					* (1.0 / 40320 - r2 * (1.0 / 3628800 - r2
+							* (1.0 / 479001600))))));
+	*sn = s * quadrant[((long)k & 3) + 1] + c * quadrant[(long)k & 3];
+	*cs = c * quadrant[((long)k & 3) + 1] - s * quadrant[(long)k & 3];
+}
+
+/**
+ * @brief Hyperbolic sine of a complex number at an accuracy tier
+ *
+ * @details The exact tier is cx_sinh(), four C library calls. The preview
+ * tier shares one exponential between sinh and cosh and one range reduction
+ * between sin and cos. Kernels pass a compile-time tier, so the choice is
+ * folded away.
+ *
+ * @ingroup complex_ops
+ *
+ * @param[in] num Argument
+ * @param[in] tier TIER_EXACT or TIER_PREVIEW
+ *
+ * @return t_complex sinh(num)
+ */
+FORMULA_INLINE t_complex	cx_sinh_tier(t_complex num, int tier)
+{
+	double	sh;
+	double	ch;
+	double	sn;
+	double	cs;
+
+	if (tier == TIER_EXACT)
+		return (cx_sinh(num));
+	fast_sinhcosh(num.real, &sh, &ch);
+	fast_sincos(num.imag, &sn, &cs);
+	return ((t_complex){sh * cs, ch * sn});
+}
+
+/**
+ * @brief Inline squared modulus of a complex number
+ *
+ * @details Divergence is tested against the squared bailout radius, which
+ * saves the square root of every iteration.
+ *
+ * @ingroup complex_ops
+ *
+ * @param[in] num Complex number
+ *
+ * @return double |num|²
+ */
+static inline double	cx_norm(t_complex num)
+{
+	return ((num.real * num.real) + (num.imag * num.imag));
+}
+
+/**
+ * @brief Iteration cap of a formula for the current view
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the zoom level
+ * @param[in] base Base iteration count of the formula
+ * @param[in] scaled Whether the cap follows the zoom level
+ *
+ * @return int Maximum number of iterations
+ */
+static inline int	formula_cap(t_data *data, int base, int scaled)
+{
+	if (scaled)
+		return (calculate_iterations(data, base));
+	return (base);
+}
+
+/**
+ * @def FORMULA_KERNELS
+ * @brief Expands a formula into its specialized escape kernels
+ *
+ * @details Defines id_diverge(), iterating z = step until |z| exceeds the
+ * bailout radius, and the id_escape() and id_batch() kernels referenced by
+ * the formula registry. step is an expression of z and c built from the
+ * inline cx_ helpers, and may pass tier to the tiered ones; every argument
+ * is a compile-time constant, so each formula gets its own loop with the
+ * step, bailout test and starting point folded in, once per accuracy tier.
+ * Julia formulas iterate from the sample with the user constant as c; the
+ * others iterate from the start value with the sample as c. id_orbit()
+ * records the points visited by the same iteration, for orbit density
+ * images.
+ *
+ * @ingroup fractal_render
+ *
+ * @param id Formula identifier, prefix of the generated functions
+ * @param step Expression computing the next z from z, c and tier
+ * @param bailout Escape radius
+ * @param base Base iteration count
+ * @param scaled Whether the iteration cap follows the zoom level
+ * @param julia Whether the sample is the starting z (1) or c (0)
+ */
+# define FORMULA_KERNELS(id, step, bailout, base, scaled, julia)	\
+FORMULA_INLINE int	id##_diverge(t_complex z, t_complex c, int iter,	\
+						const int tier)	\
+{	\
+	(void)tier;	\
+	while (iter--)	\
+	{	\
+		z = step;	\
+		if (cx_norm(z) > (bailout) * (bailout))	\
+			return (iter);	\
+	}	\
+	return (0);	\
+}	\
+	\
+FORMULA_INLINE void	id##_batch_tier(t_data *data, t_pixel_batch *batch,	\
+						const int tier)	\
+{	\
+	t_complex	point;	\
+	int			cap;	\
+	int			i;	\
+	\
+	cap = formula_cap(data, base, scaled);	\
+	i = -1;	\
+	while (++i < batch->count)	\
+	{	\
+		point = (t_complex){batch->real[i], batch->imag[i]};	\
+		if (julia)	\
+			batch->iter[i] = id##_diverge(point, data->initial_c, cap,	\
+					tier);	\
+		else	\
+			batch->iter[i] = id##_diverge(data->initial_z, point, cap,	\
+					tier);	\
+	}	\
+}	\
+	\
+static void	id##_batch(t_data *data, t_pixel_batch *batch)	\
+{	\
+	if (data->tier == TIER_PREVIEW)	\
+		id##_batch_tier(data, batch, TIER_PREVIEW);	\
+	else	\
+		id##_batch_tier(data, batch, TIER_EXACT);	\
+}	\
+	\
+static int	id##_escape(t_data *data, t_complex point)	\
+{	\
+	t_pixel_batch	batch;	\
+	\
+	batch.count = 1;	\
+	batch.real[0] = point.real;	\
+	batch.imag[0] = point.imag;	\
+	id##_batch(data, &batch);	\
+	return (batch.iter[0]);	\
+}	\
+	\
+FORMULA_INLINE int	id##_trace(t_complex z, t_complex c, int cap,	\
+						t_complex *orbit, const int tier)	\
+{	\
+	int	n;	\
+	\
+	(void)tier;	\
+	n = 0;	\
+	while (n < cap)	\
+	{	\
+		z = step;	\
+		orbit[n++] = z;	\
+		if (cx_norm(z) > (bailout) * (bailout))	\
+			return (n);	\
+	}	\
+	return (0);	\
+}	\
+	\
+static int	id##_orbit(t_data *data, t_complex point, t_complex *orbit)	\
+{	\
+	t_complex	z;	\
+	t_complex	c;	\
+	int			cap;	\
+	\
+	z = data->initial_z;	\
+	c = point;	\
+	if (julia)	\
+	{	\
+		z = point;	\
+		c = data->initial_c;	\
+	}	\
+	cap = formula_cap(data, base, scaled);	\
+	if (data->tier == TIER_PREVIEW)	\
+		return (id##_trace(z, c, cap, orbit, TIER_PREVIEW));	\
+	return (id##_trace(z, c, cap, orbit, TIER_EXACT));	\
+}
+
+#endif
@@ -9,19 +9,22 @@
  * types including Mandelbrot, Julia, and custom variations.
  *
  * @section features_sec Features
- * - Real-time fractal rendering with multi-threaded computation (8 workers)
+ * - Real-time fractal rendering on one worker thread per available CPU,
+ *   detected from the affinity mask and cgroup limits (-t overrides it)
  * - Interactive zoom centered on cursor position
  * - Multiple fractal types: Mandelbrot, Julia, Sinh, Eye, and Dragon variants
  * - Dynamic color schemes including HSV mapping and psychedelic effects
  * - Complex number arithmetic with trigonometric operations
  * - SDL2-based graphics rendering with hardware acceleration
- * - Thread-safe pixel buffer management with mutex synchronization
+ * - Rendering straight into a triple-buffered ring of frames
  *
  * @section architecture_sec Architecture
  * The application is organized into specialized modules:
  * - Complex Operations: Arithmetic and trigonometric functions for complex numbers
  * - Fractal Rendering: Multi-threaded computation engine with divergence detection
  * - Utilities: Color mapping, event handling, and pixel buffer management
+ * - Tile Cache: Escape count tiles reused across zoom levels and pans
+ * - Tile Server: Headless HTTP tile rendering for map viewers
  * - Each fractal type has its own iteration formula and divergence criteria
  *
  * @ref complex_ops Complex Number Operations
@@ -30,6 +33,10 @@
  *
  * @ref utils Utility Functions
  *
+ * @ref tiles Tile Cache
+ *
+ * @ref server Tile Server
+ *
  * @section implementation_sec Implementation
  * The renderer uses a divide-and-conquer approach where the screen is split
  * into horizontal sections, each computed by a separate thread. Complex number
@@ -58,6 +65,8 @@
  * - ./fractol eye (for Eye Mandelbrot variant)
  * - ./fractol sinh (for Sinh Mandelbrot variant)
  * - ./fractol dragon (for Dragon Mandelbrot variant)
+ * - ./fractol formula "z^3 + sinh(c)/z" c (for a formula of your own)
+ * - ./fractol serve [tcp:port|unix:path] (headless tile server)
  * Controls: Mouse wheel for zoom in/out, ESC to exit
  *
  * @section links_sec Related Links
@@ -91,7 +100,20 @@
 # include <math.h>
 # include <stdlib.h>
 # include <pthread.h>
+# include <stdatomic.h>
 # include <stdio.h>
+# include <string.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/file.h>
+# include <sys/stat.h>
+# include <sys/socket.h>
+# include <sys/un.h>
+# include <netinet/in.h>
+# include <arpa/inet.h>
+# include <poll.h>
+# include <sys/wait.h>
 
 /**
  * @defgroup constants Configuration Constants
@@ -107,80 +129,820 @@
  * - Multi-threading configuration for parallel rendering
  * - Mathematical constants for trigonometric operations
  *
- * @section module_usage_sec Usage
- * These constants are used throughout the rendering engine. Modifying them
- * requires recompilation. Higher ITER values increase detail but reduce
- * performance. NUM_THREADS should match CPU core count for optimal performance.
+ * @section module_usage_sec Usage
+ * These constants are used throughout the rendering engine. Modifying them
+ * requires recompilation. Higher ITER values increase detail but reduce
+ * performance. The number of worker threads is detected at startup, with
+ * MAX_THREADS as its upper bound.
+ *
+ * @{
+ */
+
+# ifndef SCREEN_WIDTH
+/**
+ * @def SCREEN_WIDTH
+ * @brief Horizontal resolution of the rendering window in pixels
+ *
+ * @details Defines the width of the SDL2 window and texture buffer.
+ * Default is 960 pixels. Higher values increase detail but reduce performance.
+ *
+ * @ingroup constants
+ */
+#  define SCREEN_WIDTH 960
+# endif
+
+# ifndef SCREEN_HEIGHT
+/**
+ * @def SCREEN_HEIGHT
+ * @brief Vertical resolution of the rendering window in pixels
+ *
+ * @details Defines the height of the SDL2 window and texture buffer.
+ * Default is 540 pixels. Must maintain aspect ratio with SCREEN_WIDTH.
+ *
+ * @ingroup constants
+ */
+#  define SCREEN_HEIGHT 540
+# endif
+
+# ifndef ITER
+/**
+ * @def ITER
+ * @brief Base maximum iteration count for fractal divergence detection
+ *
+ * @details Determines the maximum number of iterations before a point is
+ * considered part of the fractal set. Higher values reveal more detail at
+ * deeper zoom levels but increase computation time. Dynamically adjusted
+ * based on zoom level during rendering.
+ *
+ * @ingroup constants
+ */
+#  define ITER 20
+# endif
+
+# ifndef PI
+/**
+ * @def PI
+ * @brief Mathematical constant Pi for trigonometric calculations
+ *
+ * @details High-precision value of π used in complex trigonometric functions,
+ * color mapping algorithms, and psychedelic color generation.
+ *
+ * @ingroup constants
+ */
+#  define PI 3.14159265358979323846
+# endif
+
+# ifndef MAX_THREADS
+/**
+ * @def MAX_THREADS
+ * @brief Upper bound of worker threads for parallel fractal computation
+ *
+ * @details The worker count is taken at startup from the CPUs the process
+ * may run on (affinity mask and cgroup quota), or from the -t option, and
+ * clamped to this value. The screen is divided horizontally into one section
+ * per worker.
+ *
+ * @ingroup constants
+ */
+#  define MAX_THREADS 256
+# endif
+
+# ifndef FRAME_BUDGET_MS
+/**
+ * @def FRAME_BUDGET_MS
+ * @brief Target render time of an interactive frame in milliseconds
+ *
+ * @details Used by the adaptive iteration controller to shrink the iteration
+ * cap when a frame takes longer than this budget and to grow it when there is
+ * headroom left. Only relevant when the controller is enabled.
+ *
+ * @ingroup constants
+ */
+#  define FRAME_BUDGET_MS 40.0
+# endif
+
+# ifndef IDLE_REFINE_MS
+/**
+ * @def IDLE_REFINE_MS
+ * @brief Delay without user input before the view is refined in milliseconds
+ *
+ * @details Once the view has been idle for this long the adaptive iteration
+ * controller deepens the iteration cap beyond the interactive budget and
+ * re-renders, until the detail stops improving.
+ *
+ * @ingroup constants
+ */
+#  define IDLE_REFINE_MS 250
+# endif
+
+# ifndef ITER_SCALE_MAX
+/**
+ * @def ITER_SCALE_MAX
+ * @brief Upper bound of the adaptive iteration multiplier
+ *
+ * @details Caps the factor applied to the base iteration count so a deep
+ * idle refinement on a region that never converges cannot run forever.
+ *
+ * @ingroup constants
+ */
+#  define ITER_SCALE_MAX 256.0
+# endif
+
+# ifndef PAN_STEP
+/**
+ * @def PAN_STEP
+ * @brief Distance in pixels the view moves per arrow key press
+ *
+ * @details Pans always move the view by whole pixels, so the already
+ * computed part of the frame can be shifted instead of recomputed.
+ *
+ * @ingroup constants
+ */
+#  define PAN_STEP 32
+# endif
+
+# ifndef RENDER_TILE
+/**
+ * @def RENDER_TILE
+ * @brief Side in pixels of the squares a worker renders as one batch
+ *
+ * @details A RENDER_TILE² batch of coordinates and escape counts stays in
+ * the L1 cache, and its rows of the iteration buffer are written while still
+ * cached.
+ *
+ * @ingroup constants
+ */
+#  define RENDER_TILE 16
+# endif
+
+# ifndef VM_MAX_CODE
+/**
+ * @def VM_MAX_CODE
+ * @brief Maximum number of instructions of a compiled user formula
+ *
+ * @ingroup constants
+ */
+#  define VM_MAX_CODE 64
+# endif
+
+# ifndef VM_MAX_REGS
+/**
+ * @def VM_MAX_REGS
+ * @brief Number of complex registers of the formula virtual machine
+ *
+ * @details Registers 0 and 1 hold z and c; constants and intermediate
+ * results take the others.
+ *
+ * @ingroup constants
+ */
+#  define VM_MAX_REGS 32
+# endif
+
+# ifndef VM_LANES
+/**
+ * @def VM_LANES
+ * @brief Pixels every virtual machine instruction is applied to at once
+ *
+ * @details Each instruction runs as a loop over this many lanes, which the
+ * compiler vectorizes and which spreads the dispatch cost over the lanes.
+ * VM_MAX_REGS x VM_LANES complex registers fit in the L1 cache.
+ *
+ * @ingroup constants
+ */
+#  define VM_LANES 32
+# endif
+
+# ifndef VM_BAILOUT
+/**
+ * @def VM_BAILOUT
+ * @brief Escape radius of user formulas
+ *
+ * @ingroup constants
+ */
+#  define VM_BAILOUT 2.0
+# endif
+
+# ifndef MORPH_SPAN
+/**
+ * @def MORPH_SPAN
+ * @brief Largest real part of the Julia constant picked with the mouse
+ *
+ * @details While Julia morphing is on, the window maps to constants from
+ * -MORPH_SPAN to MORPH_SPAN along the real axis, with the same scale
+ * along the imaginary axis, whatever the zoom of the view.
+ *
+ * @ingroup constants
+ */
+#  define MORPH_SPAN 2.0
+# endif
+
+# ifndef MORPH_BLOCK
+/**
+ * @def MORPH_BLOCK
+ * @brief Side in pixels of the blocks sharing one sample in morph previews
+ *
+ * @ingroup constants
+ */
+#  define MORPH_BLOCK 4
+# endif
+
+# ifndef MORPH_ITER_SCALE
+/**
+ * @def MORPH_ITER_SCALE
+ * @brief Iteration cap multiplier of morph previews
+ *
+ * @ingroup constants
+ */
+#  define MORPH_ITER_SCALE 0.5
+# endif
+
+# ifndef MORPH_BANDS
+/**
+ * @def MORPH_BANDS
+ * @brief Bands a morph preview is computed in
+ *
+ * @details Pending pointer motion is checked between bands, and a preview
+ * whose constant is already stale is dropped before it is shown.
+ *
+ * @ingroup constants
+ */
+#  define MORPH_BANDS 4
+# endif
+
+# ifndef MORPH_SETTLE_MS
+/**
+ * @def MORPH_SETTLE_MS
+ * @brief Delay without pointer motion before a morph preview is refined
+ *
+ * @ingroup constants
+ */
+#  define MORPH_SETTLE_MS 120
+# endif
+
+# ifndef CYCLE_FRAME_MS
+/**
+ * @def CYCLE_FRAME_MS
+ * @brief Interval between two frames of colour cycling
+ *
+ * @ingroup constants
+ */
+#  define CYCLE_FRAME_MS 16
+# endif
+
+# ifndef CYCLE_RATE
+/**
+ * @def CYCLE_RATE
+ * @brief Colour phase advance of colour cycling, in radians per second
+ *
+ * @ingroup constants
+ */
+#  define CYCLE_RATE 2.0
+# endif
+
+# ifndef SYMMETRY_EPSILON
+/**
+ * @def SYMMETRY_EPSILON
+ * @brief Offset of a symmetry axis from the pixel grid treated as none
+ *
+ * @details In pixels. Views whose axis lies closer than this to a pixel
+ * row (or between two rows) are mirrored as they are; the others are first
+ * moved by under half a pixel to align it.
+ *
+ * @ingroup constants
+ */
+#  define SYMMETRY_EPSILON 1e-6
+# endif
+
+# ifndef SPLIT_SPAN
+/**
+ * @def SPLIT_SPAN
+ * @brief Real width mapped to the Julia pane of the linked view
+ *
+ * @details Each pane of the linked view shows the central half of its
+ * render target, so the Julia set opens spanning half this width.
+ *
+ * @ingroup constants
+ */
+#  define SPLIT_SPAN 6.0
+# endif
+
+# ifndef PUMP_MS
+/**
+ * @def PUMP_MS
+ * @brief Longest wait on a running render before window events are pumped
+ *
+ * @details Keeps the window repainting and closable during long renders;
+ * the loop otherwise sleeps until the render thread reports the end of
+ * its job.
+ *
+ * @ingroup constants
+ */
+#  define PUMP_MS 16
+# endif
+
+# ifndef FRAME_SLOTS
+/**
+ * @def FRAME_SLOTS
+ * @brief Number of frames in the ring between renderer and presenter
+ *
+ * @details One frame being rendered, one on screen and the newest complete
+ * one in between, so neither side ever waits for the other.
+ *
+ * @ingroup constants
+ */
+#  define FRAME_SLOTS 3
+# endif
+
+# ifndef FRAME_FRESH
+/**
+ * @def FRAME_FRESH
+ * @brief Flag of the ready slot holding a frame not presented yet
+ *
+ * @details Stored with the slot index in one atomic integer, so a slot and
+ * its state are always exchanged together.
+ *
+ * @ingroup constants
+ */
+#  define FRAME_FRESH 0x100
+# endif
+
+# ifndef ARENA_ALIGN
+/**
+ * @def ARENA_ALIGN
+ * @brief Alignment in bytes of every block handed out by a frame arena
+ *
+ * @details One cache line, which also covers the widest vector loads.
+ *
+ * @ingroup constants
+ */
+#  define ARENA_ALIGN 64
+# endif
+
+# ifndef ARENA_PAGE
+/**
+ * @def ARENA_PAGE
+ * @brief Granularity and alignment of frame arena regions in bytes
+ *
+ * @details The size of a transparent huge page on x86-64, so a region can
+ * be backed by huge pages from its first byte.
+ *
+ * @ingroup constants
+ */
+#  define ARENA_PAGE 2097152
+# endif
+
+# ifndef ARENA_SCRATCH_MB
+/**
+ * @def ARENA_SCRATCH_MB
+ * @brief Size of the scratch arena reset at every round of rendering
+ *
+ * @ingroup constants
+ */
+#  define ARENA_SCRATCH_MB 16
+# endif
+
+# ifndef SESSION_MAGIC
+/**
+ * @def SESSION_MAGIC
+ * @brief First 8 bytes of a recorded input session
+ *
+ * @details The records that follow are written in the layout of t_record
+ * on the recording machine, so a log is replayed by builds for the same
+ * architecture.
+ *
+ * @ingroup constants
+ */
+#  define SESSION_MAGIC "FRSESS01"
+# endif
+
+# ifndef SESSION_ROUND
+/**
+ * @def SESSION_ROUND
+ * @brief Record type of a rendered round, next to the SDL event types
+ *
+ * @ingroup constants
+ */
+#  define SESSION_ROUND 0
+# endif
+
+# ifndef CHECK_SIZE
+/**
+ * @def CHECK_SIZE
+ * @brief Side of the central square compared by the render check
+ *
+ * @details The scalar reference is slow; checking the centre of each view
+ * keeps a run of every formula and view within seconds.
+ *
+ * @ingroup constants
+ */
+#  define CHECK_SIZE 256
+# endif
+
+# ifndef CHECK_VIEWS
+/**
+ * @def CHECK_VIEWS
+ * @brief Default number of random views rendered by the render check
+ *
+ * @ingroup constants
+ */
+#  define CHECK_VIEWS 4
+# endif
+
+# ifndef CHECK_DEPTH
+/**
+ * @def CHECK_DEPTH
+ * @brief Deepest zoom of the random views, as a power of two
+ *
+ * @ingroup constants
+ */
+#  define CHECK_DEPTH 16
+# endif
+
+# ifndef CHECK_OPS_LEN
+/**
+ * @def CHECK_OPS_LEN
+ * @brief Length of the random arrays fed to the batch complex operations
+ *
+ * @details Not a multiple of four, so the padded tail of the vector
+ * implementations is exercised too.
+ *
+ * @ingroup constants
+ */
+#  define CHECK_OPS_LEN 4099
+# endif
+
+# ifndef SUPERSAMPLE_GRID
+/**
+ * @def SUPERSAMPLE_GRID
+ * @brief Side of the sub-sample grid used by adaptive supersampling
+ *
+ * @details Each refined pixel is split into SUPERSAMPLE_GRID² cells and one
+ * jittered sample is taken per cell. Default is 4 (16 samples per pixel).
+ *
+ * @ingroup constants
+ */
+#  define SUPERSAMPLE_GRID 4
+# endif
+
+# ifndef SUPERSAMPLE_THRESHOLD
+/**
+ * @def SUPERSAMPLE_THRESHOLD
+ * @brief Escape count difference that marks a pixel for supersampling
+ *
+ * @details A pixel is refined when its escape count differs from one of its
+ * eight neighbours by more than this value. Neighbouring colour bands differ
+ * by one and are left alone; sharp edges and set boundaries are refined.
+ *
+ * @ingroup constants
+ */
+#  define SUPERSAMPLE_THRESHOLD 1
+# endif
+
+# ifndef DENSITY_GRID
+/**
+ * @def DENSITY_GRID
+ * @brief Side of the importance map over the orbit starting points
+ *
+ * @details The sampled square is split into DENSITY_GRID² cells. Cells
+ * whose orbits reach the view are drawn more often, so fewer samples are
+ * spent on points that never show up on screen.
+ *
+ * @ingroup constants
+ */
+#  define DENSITY_GRID 64
+# endif
+
+/**
+ * @def DENSITY_CELLS
+ * @brief Number of cells of the orbit importance map
+ *
+ * @ingroup constants
+ */
+# define DENSITY_CELLS	(DENSITY_GRID * DENSITY_GRID)
+
+# ifndef DENSITY_RADIUS
+/**
+ * @def DENSITY_RADIUS
+ * @brief Half side of the square the orbit starting points are drawn from
+ *
+ * @details Centred on the origin. A radius of 2 covers every c of the
+ * Mandelbrot set and every starting z of the quadratic Julia sets.
+ *
+ * @ingroup constants
+ */
+#  define DENSITY_RADIUS 2.0
+# endif
+
+# ifndef DENSITY_EXPLORE
+/**
+ * @def DENSITY_EXPLORE
+ * @brief Share of orbit samples drawn uniformly over the importance map
+ *
+ * @details Keeps every cell sampled, so cells that were never useful still
+ * get a chance once the view moves and the weights stay bounded.
+ *
+ * @ingroup constants
+ */
+#  define DENSITY_EXPLORE 0.25
+# endif
+
+# ifndef DENSITY_PASS_MS
+/**
+ * @def DENSITY_PASS_MS
+ * @brief Target duration of one progressive orbit density pass
+ *
+ * @details The number of samples per pass follows the measured speed so
+ * the partial image is shown and input is handled at this rate.
+ *
+ * @ingroup constants
+ */
+#  define DENSITY_PASS_MS 50.0
+# endif
+
+# ifndef DENSITY_REPORT_MS
+/**
+ * @def DENSITY_REPORT_MS
+ * @brief Interval between orbit density sampling rate reports
+ *
+ * @ingroup constants
+ */
+#  define DENSITY_REPORT_MS 2000
+# endif
+
+# ifndef TILE_SIZE
+/**
+ * @def TILE_SIZE
+ * @brief Side of a cached tile in escape count samples
+ *
+ * @details Tiles are TILE_SIZE x TILE_SIZE grids of escape counts. Small
+ * enough that a view needs only its visible tiles, large enough to keep the
+ * per-tile bookkeeping negligible. Must be a power of two.
+ *
+ * @ingroup constants
+ */
+#  define TILE_SIZE 64
+# endif
+
+# ifndef TILE_ROOT_SPAN
+/**
+ * @def TILE_ROOT_SPAN
+ * @brief Side of a level 0 tile in complex plane units
+ *
+ * @details Every level halves the side of its tiles, so a tile at level L
+ * covers TILE_ROOT_SPAN / 2^L on each axis and tiles of consecutive levels
+ * nest like the nodes of a quadtree.
+ *
+ * @ingroup constants
+ */
+#  define TILE_ROOT_SPAN 4.0
+# endif
+
+# ifndef TILE_BASE_LEVEL
+/**
+ * @def TILE_BASE_LEVEL
+ * @brief Tile level whose sample spacing matches the initial view
+ *
+ * @details The iteration cap of a tile is derived from its level as if the
+ * view were zoomed 2^(L - TILE_BASE_LEVEL) times, so a tile always holds the
+ * same escape counts no matter which view requested it.
+ *
+ * @ingroup constants
+ */
+#  define TILE_BASE_LEVEL 5
+# endif
+
+# ifndef TILE_CACHE_MB
+/**
+ * @def TILE_CACHE_MB
+ * @brief Memory cap of the in-memory tile cache in megabytes
+ *
+ * @details When the cached tiles exceed this size, the least recently used
+ * ones are evicted. Tiles shown by the current frame are never evicted, so
+ * the cap may be exceeded by one frame worth of tiles.
+ *
+ * @ingroup constants
+ */
+#  define TILE_CACHE_MB 64
+# endif
+
+# ifndef TILE_BUCKETS
+/**
+ * @def TILE_BUCKETS
+ * @brief Number of hash buckets of the tile cache
+ *
+ * @details Must be a power of two. The default fits the number of tiles the
+ * default TILE_CACHE_MB holds, keeping chains around one tile long.
+ *
+ * @ingroup constants
+ */
+#  define TILE_BUCKETS 4096
+# endif
+
+# ifndef TILE_STORE_PATH
+/**
+ * @def TILE_STORE_PATH
+ * @brief Base path of the persistent tile store
+ *
+ * @details The store is made of TILE_STORE_PATH.idx, the index of stored
+ * tiles, and TILE_STORE_PATH.dat, their escape counts. Both are created in
+ * the working directory by default and shared by the window's tile mode
+ * and the tile server, one process at a time.
+ *
+ * @ingroup constants
+ */
+#  define TILE_STORE_PATH "fractol_tiles"
+# endif
+
+# ifndef TILE_STORE_MB
+/**
+ * @def TILE_STORE_MB
+ * @brief Size cap of the persistent tile store in megabytes
+ *
+ * @details Sizes the data file, which holds a fixed number of tile slots.
+ * Changing it discards the stored tiles on the next start. The file is
+ * sparse, so slots never written take no disk space.
+ *
+ * @ingroup constants
+ */
+#  define TILE_STORE_MB 256
+# endif
+
+# ifndef TILE_STORE_WAYS
+/**
+ * @def TILE_STORE_WAYS
+ * @brief Number of slots a tile may be stored in
+ *
+ * @details The store is set-associative: a tile address hashes to a set of
+ * TILE_STORE_WAYS consecutive slots, and when the set is full its least
+ * recently used tile is evicted. Lookups never probe more than one set.
+ *
+ * @ingroup constants
+ */
+#  define TILE_STORE_WAYS 8
+# endif
+
+# ifndef BMP_HEADER_SIZE
+/**
+ * @def BMP_HEADER_SIZE
+ * @brief Size of the file and info headers of the BMP images written
+ *
+ * @ingroup constants
+ */
+#  define BMP_HEADER_SIZE 54
+# endif
+
+# ifndef SERVER_ADDRESS
+/**
+ * @def SERVER_ADDRESS
+ * @brief Default address of the tile server
+ *
+ * @details Either "tcp:[host:]port" or "unix:path". Without a host the
+ * server only listens on the loopback interface.
+ *
+ * @ingroup constants
+ */
+#  define SERVER_ADDRESS "tcp:8080"
+# endif
+
+# ifndef SERVER_TILE_PX
+/**
+ * @def SERVER_TILE_PX
+ * @brief Side of a served tile in pixels
+ *
+ * @details Slippy-map viewers expect 256 pixel tiles. Must be TILE_SIZE
+ * times a power of two, see SERVER_LEVEL_SHIFT.
+ *
+ * @ingroup constants
+ */
+#  define SERVER_TILE_PX 256
+# endif
+
+# ifndef SERVER_LEVEL_SHIFT
+/**
+ * @def SERVER_LEVEL_SHIFT
+ * @brief Tile cache level of served zoom 0, log2(SERVER_TILE_PX / TILE_SIZE)
+ *
+ * @details A served tile of zoom z has the sample spacing of cache level
+ * z + SERVER_LEVEL_SHIFT, so it gets the iteration cap of that level.
+ *
+ * @ingroup constants
+ */
+#  define SERVER_LEVEL_SHIFT 2
+# endif
+
+# ifndef SERVER_MAX_ZOOM
+/**
+ * @def SERVER_MAX_ZOOM
+ * @brief Deepest zoom level answered by the tile server
+ *
+ * @details Beyond this depth double precision samples stop resolving
+ * distinct points, so deeper requests are answered with 404.
+ *
+ * @ingroup constants
+ */
+#  define SERVER_MAX_ZOOM 40
+# endif
+
+# ifndef SERVER_MAX_CLIENTS
+/**
+ * @def SERVER_MAX_CLIENTS
+ * @brief Connections the tile server reads requests from at once
+ *
+ * @details Clients waiting for a tile no longer count, so many more
+ * requests than this can be in flight.
+ *
+ * @ingroup constants
+ */
+#  define SERVER_MAX_CLIENTS 256
+# endif
+
+# ifndef SERVER_REQUEST_MAX
+/**
+ * @def SERVER_REQUEST_MAX
+ * @brief Size limit of a request header in bytes
  *
- * @{
+ * @ingroup constants
  */
+#  define SERVER_REQUEST_MAX 2048
+# endif
 
-# ifndef SCREEN_WIDTH
+# ifndef SERVER_SEND_TIMEOUT_MS
 /**
- * @def SCREEN_WIDTH
- * @brief Horizontal resolution of the rendering window in pixels
+ * @def SERVER_SEND_TIMEOUT_MS
+ * @brief Time a response may stay blocked on a slow client
  *
- * @details Defines the width of the SDL2 window and texture buffer.
- * Default is 960 pixels. Higher values increase detail but reduce performance.
+ * @details Responses are sent from the event loop, so a client that stops
+ * reading is dropped after this delay instead of stalling other clients.
  *
  * @ingroup constants
  */
-#  define SCREEN_WIDTH 960
+#  define SERVER_SEND_TIMEOUT_MS 1000
 # endif
 
-# ifndef SCREEN_HEIGHT
+# ifndef SERVER_READ_TIMEOUT_MS
 /**
- * @def SCREEN_HEIGHT
- * @brief Vertical resolution of the rendering window in pixels
+ * @def SERVER_READ_TIMEOUT_MS
+ * @brief Time a client may take to send its whole request header
  *
- * @details Defines the height of the SDL2 window and texture buffer.
- * Default is 540 pixels. Must maintain aspect ratio with SCREEN_WIDTH.
+ * @details Slower clients are answered 408 and closed, so idle connections
+ * cannot keep every client slot taken.
  *
  * @ingroup constants
  */
-#  define SCREEN_HEIGHT 540
+#  define SERVER_READ_TIMEOUT_MS 5000
 # endif
 
-# ifndef ITER
+# ifndef DIST_MAGIC
 /**
- * @def ITER
- * @brief Base maximum iteration count for fractal divergence detection
- *
- * @details Determines the maximum number of iterations before a point is
- * considered part of the fractal set. Higher values reveal more detail at
- * deeper zoom levels but increase computation time. Dynamically adjusted
- * based on zoom level during rendering.
+ * @def DIST_MAGIC
+ * @brief Tag opening every distributed render message ("FDR1")
  *
  * @ingroup constants
  */
-#  define ITER 20
+#  define DIST_MAGIC 0x31524446u
 # endif
 
-# ifndef PI
+# ifndef DIST_TILE_PX
 /**
- * @def PI
- * @brief Mathematical constant Pi for trigonometric calculations
+ * @def DIST_TILE_PX
+ * @brief Side in pixels of the poster squares handed to workers
  *
- * @details High-precision value of π used in complex trigonometric functions,
- * color mapping algorithms, and psychedelic color generation.
+ * @ingroup constants
+ */
+#  define DIST_TILE_PX 256
+# endif
+
+# ifndef DIST_MAX_WORKERS
+/**
+ * @def DIST_MAX_WORKERS
+ * @brief Maximum number of workers connected to a coordinator
  *
  * @ingroup constants
  */
-#  define PI 3.14159265358979323846
+#  define DIST_MAX_WORKERS 256
 # endif
 
-# ifndef NUM_THREADS
+# ifndef DIST_BACKUP_MS
 /**
- * @def NUM_THREADS
- * @brief Number of worker threads for parallel fractal computation
+ * @def DIST_BACKUP_MS
+ * @brief Minimum running time before a task gets a backup copy
+ *
+ * @details Once no task is pending, a task running for longer than this and
+ * twice the average task time is sent to an idle worker as well.
  *
- * @details Defines how many POSIX threads are spawned for parallel rendering.
- * Default is 8. Should be set to match the number of CPU cores for optimal
- * performance. The screen is divided horizontally into NUM_THREADS sections.
+ * @ingroup constants
+ */
+#  define DIST_BACKUP_MS 2000
+# endif
+
+# ifndef DIST_TIMEOUT_MS
+/**
+ * @def DIST_TIMEOUT_MS
+ * @brief Time a coordinator waits for a greeting or the rest of a result
  *
  * @ingroup constants
  */
-#  define NUM_THREADS 8
+#  define DIST_TIMEOUT_MS 5000
 # endif
 
 /** @} */
@@ -199,9 +961,38 @@ typedef enum e_fractals
 	JULIA = 1,               ///< Julia set with fixed c parameter
 	SINH_MANDELBROT = 2,     ///< Mandelbrot variant using hyperbolic sine
 	EYE_MANDELBROT = 3,      ///< Mandelbrot variant with z³ iteration
-	DRAGON_MANDELBROT = 4    ///< Dragon fractal variant with sinh and inverse
+	DRAGON_MANDELBROT = 4,   ///< Dragon fractal variant with sinh and inverse
+	USER_FORMULA = 5,        ///< Formula compiled from the command line
+	FRACTAL_COUNT            ///< Number of formulas in the registry
 }	t_fractals; 	         ///< Typedef of enum e_fractals
 
+/**
+ * @enum e_tier
+ * @brief Accuracy tiers of the transcendental functions in the kernels
+ *
+ * The interactive view renders at the preview tier; exports, the tile
+ * server and distributed renders use the exact one.
+ */
+typedef enum e_tier
+{
+	TIER_EXACT = 0,     ///< C library functions, correctly rounded or nearly
+	TIER_PREVIEW = 1    ///< Fused fast functions, within 1e-10
+}	t_tier;             ///< Typedef of enum e_tier
+
+/**
+ * @enum e_mirror
+ * @brief Symmetries of the images of a formula
+ *
+ * Declared in the formula registry; the renderer computes one side of the
+ * axis or centre of symmetry and mirrors the other.
+ */
+typedef enum e_mirror
+{
+	MIRROR_NONE = 0,        ///< No symmetry known
+	MIRROR_CONJUGATE = 1,   ///< Symmetric about the real axis
+	MIRROR_ROTATION = 2     ///< Symmetric under a half turn about the origin
+}	t_mirror;               ///< Typedef of enum e_mirror
+
 /**
  * @struct s_vector2
  * @brief 2D integer vector representing screen coordinates
@@ -230,22 +1021,504 @@ typedef struct s_complex
 	double	imag;   ///< Imaginary component of the complex number
 }	t_complex; 		///< Typedef of struct s_complex
 
+/**
+ * @struct s_complex_soa
+ * @brief Array of complex numbers stored as structure of arrays
+ *
+ * Element i is (real[i], imag[i]). Keeping the parts in separate arrays lets
+ * the batch operations load several elements per vector register.
+ */
+typedef struct s_complex_soa
+{
+	double	*real;  ///< Real parts
+	double	*imag;  ///< Imaginary parts
+}	t_complex_soa;  ///< Typedef of struct s_complex_soa
+
+/**
+ * @struct s_complex_ops
+ * @brief Batch complex operations of one instruction set
+ *
+ * Every operation computes n elements, dst[i] = op(a[i], b[i]). The
+ * destination may be one of the operands. All implementations round exactly
+ * like the scalar functions, so switching between them never changes an
+ * image.
+ */
+typedef struct s_complex_ops
+{
+	const char	*name;  ///< Instruction set, as reported to the user
+	void		(*add)(t_complex_soa, t_complex_soa, t_complex_soa, int);
+	void		(*sub)(t_complex_soa, t_complex_soa, t_complex_soa, int);
+	void		(*mul)(t_complex_soa, t_complex_soa, t_complex_soa, int);
+	void		(*div)(t_complex_soa, t_complex_soa, t_complex_soa, int);
+	void		(*inv)(t_complex_soa, t_complex_soa, int);
+	void		(*sinh)(t_complex_soa, t_complex_soa, int);
+	void		(*norm)(double *, t_complex_soa, int);
+}	t_complex_ops;      ///< Typedef of struct s_complex_ops
+
+/**
+ * @struct s_iter_ctrl
+ * @brief State of the time-budgeted adaptive iteration controller
+ *
+ * When enabled, the iteration cap is no longer derived from the zoom level
+ * alone. Instead each frame reports its render time and how many pixels
+ * escaped only in the last iterations, and the controller rescales the cap
+ * to keep interactive frames within FRAME_BUDGET_MS. The boost factor is
+ * applied on top of the scale while the view is idle to deepen detail.
+ */
+typedef struct s_iter_ctrl
+{
+	int		enabled;    ///< Controller active flag (0 = zoom-based cap)
+	double	scale;      ///< Multiplier of the base cap for interactive frames
+	double	boost;      ///< Extra multiplier applied during idle refinement
+	double	last_ms;    ///< Render time of the last frame in milliseconds
+	double	late;       ///< Fraction of pixels escaping near the cap
+	Uint32	last_input; ///< Tick of the last user input (SDL_GetTicks)
+}	t_iter_ctrl;        ///< Typedef of struct s_iter_ctrl
+
+/**
+ * @struct s_morph
+ * @brief State of interactive Julia morphing
+ *
+ * While enabled, pointer motion sets the Julia constant. Each new constant
+ * is first shown as a coarse, shallow preview, then rendered in full once
+ * the pointer has been still for MORPH_SETTLE_MS.
+ */
+typedef struct s_morph
+{
+	int		enabled;    ///< Pointer motion drives the Julia constant
+	int		moving;     ///< The view shows a preview, not a full render
+	int		dirty;      ///< A preview of a new constant is due
+	Uint32	last_move;  ///< Tick of the last pointer motion
+	int		previews;   ///< Previews shown
+	int		cancelled;  ///< Previews dropped for a newer constant
+}	t_morph;            ///< Typedef of struct s_morph
+
+/**
+ * @struct s_cycle
+ * @brief State of continuous colour cycling
+ *
+ * While enabled, the stored escape counts are recoloured every
+ * CYCLE_FRAME_MS with a colour phase advancing at CYCLE_RATE, without
+ * running any fractal kernel.
+ */
+typedef struct s_cycle
+{
+	int		enabled;    ///< The colours cycle while the view is idle
+	double	phase;      ///< Hue rotation of HSV colouring in radians
+	Uint32	last;       ///< Tick of the last cycled frame
+	int		frames;     ///< Frames cycled since enabled
+	double	ms;         ///< Total time of their colour passes
+}	t_cycle;            ///< Typedef of struct s_cycle
+
+/**
+ * @struct s_symmetry
+ * @brief Mirrored part of the frame being rendered
+ *
+ * Pixel (x, y) of the band takes the escape count of (x, axis.y - y) for
+ * conjugate symmetry and of (axis.x - x, axis.y - y) for a half turn, both
+ * axes being given as the sum of the coordinates of mirrored pixels.
+ */
+typedef struct s_symmetry
+{
+	t_mirror	mirror;     ///< Symmetry applied (MIRROR_NONE = none)
+	t_vector2	axis;       ///< Twice the pixel position of the axis
+	SDL_Rect	band;       ///< Pixels copied rather than computed
+}	t_symmetry;             ///< Typedef of struct s_symmetry
+
+/**
+ * @struct s_split
+ * @brief Linked Mandelbrot and Julia view
+ *
+ * The pane is a second application state with its own render target and
+ * escape counts, rendered by the same worker threads as the main view. The
+ * pane under the pointer has focus and its pending work is rendered first.
+ */
+typedef struct s_split
+{
+	struct s_data	*pane;  ///< Julia pane (NULL = linked view off)
+	int				focus;  ///< The Julia pane has the pointer (0 = main)
+}	t_split;                ///< Typedef of struct s_split
+
+/**
+ * @struct s_arena
+ * @brief Bump allocator over one large aligned memory region
+ *
+ * The region is mapped once, aligned to ARENA_PAGE so the kernel can back
+ * it with huge pages when asked to. Blocks are carved from it at ARENA_ALIGN boundaries
+ * with one atomic addition, so worker threads can allocate too, and are
+ * never freed one by one: a reset hands the whole region out again.
+ */
+typedef struct s_arena
+{
+	Uint8			*base;  ///< Start of the region (NULL = empty arena)
+	size_t			size;   ///< Bytes in the region
+	atomic_size_t	used;   ///< Bytes handed out since the last reset
+	size_t			peak;   ///< Most bytes handed out before a reset
+}	t_arena;                ///< Typedef of struct s_arena
+
+/**
+ * @struct s_record
+ * @brief One entry of a recorded input session
+ *
+ * Either an input event, as its SDL event type and the fields the handlers
+ * read, or a round of the event loop that rendered something, with the
+ * view it left and the time-dependent state of the iteration controller.
+ */
+typedef struct s_record
+{
+	Uint32	ms;         ///< Tick of the event or of the round start
+	int		type;       ///< SDL event type, or SESSION_ROUND
+	int		arg[5];     ///< Key; wheel steps, direction, x, y; motion
+	double	view[7];    ///< Round: min, max, zoom factor and Julia c
+	double	ctrl[2];    ///< Round: controller scale and last frame time
+}	t_record;           ///< Typedef of struct s_record
+
+/**
+ * @struct s_session
+ * @brief Recording or replay of the input of a window session
+ *
+ * The view state reads time through the session clock, frozen for each
+ * input event and each round of the event loop. Recording logs the input
+ * events and rendered rounds with that clock; replay sets the clock from
+ * the log, so timers such as morph refinement fire on the same rounds.
+ */
+typedef struct s_session
+{
+	int			fd;         ///< Log being recorded (-1 = not recording)
+	int			replay;     ///< The clock and pointer come from a log
+	int			pending;    ///< A round was posted and not logged yet
+	Uint32		now;        ///< Tick seen by the view state
+	t_vector2	mouse;      ///< Pointer position of a replayed wheel event
+	Uint8		*map;       ///< Replayed log mapped in memory
+	size_t		size;       ///< Bytes in the replayed log
+	size_t		next;       ///< Offset of the next record to replay
+	char		*args[5];   ///< Replayed command line, NULL-terminated
+	int			argc;       ///< Entries of args, args[0] included
+	int			frames;     ///< Rounds replayed
+	int			diverged;   ///< Rounds leaving a view unlike the log
+	double		total_ms;   ///< Render time of all replayed rounds
+	double		worst_ms;   ///< Render time of the slowest round
+}	t_session;              ///< Typedef of struct s_session
+
+/**
+ * @struct s_frame_ring
+ * @brief Triple-buffered frames between the renderer and the presenter
+ *
+ * The renderer owns the back slot and the presenter the front slot; ready
+ * holds the third, flagged FRAME_FRESH while it holds a frame the presenter
+ * has not taken. Either side trades its slot for the ready one with a
+ * single atomic exchange, so no slot is ever written while it is read and
+ * neither side waits for the other.
+ */
+typedef struct s_frame_ring
+{
+	Uint32		*slot[FRAME_SLOTS]; ///< Full-screen ARGB8888 frames
+	int			back;               ///< Slot being rendered (renderer)
+	SDL_Rect	area[FRAME_SLOTS];  ///< Screen area rendered into each slot
+	int			front;              ///< Slot on the texture (presenter)
+	atomic_int	ready;              ///< Third slot, with FRAME_FRESH
+}	t_frame_ring;                   ///< Typedef of struct s_frame_ring
+
+/**
+ * @struct s_pipeline
+ * @brief Render thread running the pending work of the event loop
+ *
+ * The event loop posts one job per round and, while it runs, only pumps
+ * window events and presents finished frames; input is handled once the
+ * job is done, so the application state is never shared with the job.
+ */
+typedef struct s_pipeline
+{
+	pthread_t		thread;     ///< Render thread
+	pthread_mutex_t	lock;       ///< Guards posted and quit
+	pthread_cond_t	wake;       ///< Signals a posted job or the exit
+	pthread_cond_t	done;       ///< Signals the end of a job
+	int				(*job)(struct s_data *);    ///< Work of one round
+	atomic_int		busy;       ///< A job is posted or running
+	int				worked;     ///< The last job rendered anything
+	int				posted;     ///< A job waits for the render thread
+	int				quit;       ///< The render thread must exit
+	int				started;    ///< The render thread is running
+}	t_pipeline;                 ///< Typedef of struct s_pipeline
+
+/**
+ * @struct s_density_worker
+ * @brief Private orbit density state of one worker thread
+ *
+ * Each worker accumulates into its own histogram and cell counters with its
+ * own random generator, so the sampling loop writes no shared memory and
+ * needs no atomics. Everything is merged once the pass is over.
+ */
+typedef struct s_density_worker
+{
+	float	*hist;                  ///< Orbit weight per pixel
+	Uint32	drawn[DENSITY_CELLS];   ///< Samples taken per cell
+	Uint32	useful[DENSITY_CELLS];  ///< Samples reaching the view
+	Uint64	rng;                    ///< xorshift64* state
+	float	peak;                   ///< Highest merged value of its rows
+}	t_density_worker;               ///< Typedef of struct s_density_worker
+
+/**
+ * @struct s_density
+ * @brief Progressive orbit density (Buddhabrot) image state
+ *
+ * Starting points are drawn from the importance map, whose cell
+ * probabilities are kept as a cumulative table. Each sample is weighted by
+ * the inverse of its cell's relative probability, so the image converges
+ * to the one uniform sampling gives.
+ */
+typedef struct s_density
+{
+	int					enabled;    ///< Orbit density mode active (0 = off)
+	t_density_worker	*workers;   ///< One private state per worker thread
+	int					count;      ///< Number of workers allocated
+	float				*hist;      ///< Merged orbit weight per pixel
+	float				peak;       ///< Highest merged value
+	double				cdf[DENSITY_CELLS];     ///< Cumulative cell probability
+	double				weight[DENSITY_CELLS];  ///< Sample weight per cell
+	double				drawn[DENSITY_CELLS];   ///< Samples taken per cell
+	double				useful[DENSITY_CELLS];  ///< Samples reaching the view
+	int					per_thread; ///< Samples per worker in one pass
+	double				samples;    ///< Samples taken since the last reset
+	double				busy_ms;    ///< Sampling time since the last reset
+	Uint32				reported;   ///< Tick of the last rate report
+}	t_density;                      ///< Typedef of struct s_density
+
+/**
+ * @struct s_cpu
+ * @brief Worker thread count and placement
+ *
+ * Filled by cpu_detect() and the command-line options. When pinning is on,
+ * worker i runs on cpus[i % available] only, so it keeps the same core, and
+ * NUMA node, from one frame to the next.
+ */
+typedef struct s_cpu
+{
+	int	threads;            ///< Worker threads per parallel pass
+	int	pin;                ///< Pin workers to cores flag (0 = off)
+	int	available;          ///< CPUs in the affinity mask
+	int	cpus[MAX_THREADS];  ///< Allowed CPU ids, in mask order
+}	t_cpu;                  ///< Typedef of struct s_cpu
+
+/**
+ * @enum e_vm_opcode
+ * @brief Instructions of the user formula virtual machine
+ *
+ * Every instruction reads registers a (and b for binary operations) and
+ * writes register dst, on every lane.
+ */
+typedef enum e_vm_opcode
+{
+	VM_ADD,     ///< a + b
+	VM_SUB,     ///< a - b
+	VM_MUL,     ///< a * b
+	VM_DIV,     ///< a / b
+	VM_POW,     ///< a ^ b for a non-integer or variable exponent
+	VM_NEG,     ///< -a
+	VM_INV,     ///< 1 / a
+	VM_CONJ,    ///< Complex conjugate of a
+	VM_ABS,     ///< |a| as a real number
+	VM_EXP,     ///< exp(a)
+	VM_LOG,     ///< Principal natural logarithm of a
+	VM_SQRT,    ///< Principal square root of a
+	VM_SIN,     ///< sin(a)
+	VM_COS,     ///< cos(a)
+	VM_SINH,    ///< sinh(a)
+	VM_COSH     ///< cosh(a)
+}	t_vm_opcode;///< Typedef of enum e_vm_opcode
+
+/**
+ * @struct s_vm_op
+ * @brief One register instruction of a compiled formula
+ */
+typedef struct s_vm_op
+{
+	Uint8	op;     ///< t_vm_opcode
+	Uint8	dst;    ///< Destination register
+	Uint8	a;      ///< First operand register
+	Uint8	b;      ///< Second operand register (binary operations)
+}	t_vm_op;        ///< Typedef of struct s_vm_op
+
+/**
+ * @struct s_program
+ * @brief User formula compiled to register bytecode
+ *
+ * Constant subexpressions are folded at compile time into constant
+ * registers, loaded once per batch; only the instructions depending on z or
+ * c are left in the code. Those depending on c alone come first and run
+ * once per pixel rather than once per iteration.
+ */
+typedef struct s_program
+{
+	t_vm_op		code[VM_MAX_CODE];      ///< Instructions, in order
+	int			len;                    ///< Number of instructions
+	int			nregs;                  ///< Registers used
+	int			setup;                  ///< Leading instructions using c only
+	int			result;                 ///< Register holding the result
+	Uint8		constant[VM_MAX_REGS];  ///< Whether a register is constant
+	t_complex	value[VM_MAX_REGS];     ///< Value of the constant registers
+	Uint32		hash;                   ///< Hash of the source (0 = none)
+}	t_program;                          ///< Typedef of struct s_program
+
+/**
+ * @struct s_tile_key
+ * @brief Address of a cached tile
+ *
+ * Identifies the escape counts a tile holds: the fractal, its parameter
+ * (the Julia constant or the Mandelbrot starting value), the precision tier
+ * the samples were computed with, the user formula if any, the quadtree level
+ * and the tile coordinates on the power-of-two grid of that level. Tile
+ * (tx, ty) covers [tx, tx + 1) x [ty, ty + 1) tile sides of the plane.
+ */
+typedef struct s_tile_key
+{
+	t_fractals	type;   ///< Fractal type of the tile
+	t_complex	param;  ///< initial_c for Julia sets, initial_z otherwise
+	int			tier;   ///< Accuracy tier, see tile_key_tier() (t_tier)
+	Uint32		variant;///< Hash of a user formula (0 = built-in formula)
+	int			level;  ///< Quadtree level (tile side TILE_ROOT_SPAN / 2^level)
+	long		tx;     ///< Horizontal tile coordinate on the level grid
+	long		ty;     ///< Vertical tile coordinate on the level grid
+}	t_tile_key;         ///< Typedef of struct s_tile_key
+
+/**
+ * @struct s_tile
+ * @brief Cached tile of escape counts
+ *
+ * Linked both into a hash bucket chain and into the least recently used
+ * list of the cache. The samples either follow the structure in the same
+ * allocation or live in a slot of the memory-mapped tile store.
+ */
+typedef struct s_tile
+{
+	t_tile_key		key;        ///< Address of the tile
+	Uint32			stamp;      ///< Last frame that showed the tile
+	int				slot;       ///< Store slot holding the samples (-1 = heap)
+	struct s_tile	*chain;     ///< Next tile in the same hash bucket
+	struct s_tile	*prev;      ///< More recently used neighbour
+	struct s_tile	*next;      ///< Less recently used neighbour
+	int				*iters;     ///< TILE_SIZE² escape counts, row-major
+}	t_tile;                     ///< Typedef of struct s_tile
+
+/**
+ * @struct s_store_header
+ * @brief Header of the persistent tile store index
+ *
+ * Records the layout the store was created with. A store whose header does
+ * not match the running configuration is discarded and recreated.
+ */
+typedef struct s_store_header
+{
+	char	magic[8];       ///< "FRACTOL" file signature
+	Uint32	version;        ///< Layout version of the store
+	Uint32	entry_size;     ///< Size of an index entry in bytes
+	Uint32	tile_size;      ///< TILE_SIZE the samples were stored with
+	Uint32	ways;           ///< TILE_STORE_WAYS of the set-associative index
+	Uint32	iter;           ///< ITER the escape counts were computed with
+	Uint32	base_level;     ///< TILE_BASE_LEVEL the caps were derived from
+	Uint64	slots;          ///< Number of tile slots in the data file
+	Uint64	clock;          ///< Frame counter used for LRU ordering
+}	t_store_header;         ///< Typedef of struct s_store_header
+
+/**
+ * @struct s_store_entry
+ * @brief Index entry of one slot of the persistent tile store
+ */
+typedef struct s_store_entry
+{
+	t_tile_key	key;        ///< Address of the tile held by the slot
+	Uint64		last_use;   ///< Store clock of the last lookup
+	Uint32		valid;      ///< The slot holds fully computed samples
+	Uint32		reserved;   ///< Padding kept zero
+}	t_store_entry;          ///< Typedef of struct s_store_entry
+
+/**
+ * @struct s_tile_store
+ * @brief Memory-mapped, set-associative on-disk tile store
+ *
+ * Both files are mapped shared, so tiles found in the store are used in
+ * place without reading or copying, and new tiles are computed straight
+ * into their slot. The index file is locked while a process owns the store.
+ */
+typedef struct s_tile_store
+{
+	int				fd_index;   ///< Locked index file descriptor (-1 = closed)
+	int				fd_data;    ///< Data file descriptor
+	t_store_header	*header;    ///< Mapped index header
+	t_store_entry	*entries;   ///< Mapped index entries, one per slot
+	int				*samples;   ///< Mapped escape counts of every slot
+	size_t			slots;      ///< Number of slots
+	size_t			index_bytes;///< Size of the index mapping
+	size_t			data_bytes; ///< Size of the data mapping
+}	t_tile_store;               ///< Typedef of struct s_tile_store
+
+/**
+ * @struct s_tile_cache
+ * @brief In-memory LRU cache of escape count tiles
+ *
+ * Holds the hash table and recency list of the cached tiles, the persistent
+ * store they are backed by, plus the tiles
+ * covering the frame being rendered: grid holds grid_w x grid_h tiles
+ * starting at tile (grid_x, grid_y) of the frame level, and pending the ones
+ * that still have to be computed.
+ */
+typedef struct s_tile_cache
+{
+	int			enabled;    ///< Views are composed from tiles (0 = off)
+	t_tile		**buckets;  ///< TILE_BUCKETS hash chains
+	t_tile		*head;      ///< Most recently used tile
+	t_tile		*tail;      ///< Least recently used tile
+	t_tile		*spare;     ///< Evicted tiles with their own samples
+	t_tile		*spare_slots;///< Evicted tiles backed by the store
+	size_t		bytes;      ///< Memory held by cached tiles
+	size_t		limit;      ///< Memory cap before evicting tiles
+	Uint32		frame;      ///< Number of the frame being composed
+	long		hits;       ///< Tiles found in the cache
+	long		loads;      ///< Tiles mapped from the persistent store
+	long		misses;     ///< Tiles that had to be computed
+	t_tile_store	store;  ///< Persistent store behind the cache
+	t_tile		**owners;   ///< Cached tile using each store slot
+	t_tile		**grid;     ///< Tiles covering the frame
+	t_tile		**pending;  ///< Tiles of the frame not computed yet
+	int			pending_len;///< Number of pending tiles
+	int			grid_size;  ///< Allocated entries of grid and pending
+	int			level;      ///< Quadtree level of the frame
+	double		step;       ///< Sample spacing of the frame level
+	long		grid_x;     ///< Tile coordinate of the first grid column
+	long		grid_y;     ///< Tile coordinate of the first grid row
+	int			grid_w;     ///< Grid columns
+	int			grid_h;     ///< Grid rows
+}	t_tile_cache;           ///< Typedef of struct s_tile_cache
+
 /**
  * @struct s_data
  * @brief Main application state containing SDL resources and fractal parameters
  *
  * Central data structure holding all rendering state, SDL2 resources, fractal
  * configuration, and synchronization primitives. Shared across all rendering
- * threads through read-only access to most fields and mutex-protected writes
- * to the pixel buffer.
+ * threads through read-only access to most fields and writes to disjoint
+ * regions of the pixel buffer.
  */
 typedef struct s_data
 {
 	SDL_Window		*window;        ///< SDL2 window handle
 	SDL_Renderer	*renderer;      ///< SDL2 hardware renderer
 	SDL_Texture		*texture;       ///< SDL2 texture for pixel buffer
-	Uint32			*pixels;        ///< ARGB8888 pixel buffer array
+	Uint32			*pixels;        ///< ARGB8888 render target (ring back slot)
+	int				*iters;         ///< Escape count of every pixel
+	int				iters_cap;      ///< Iteration cap of the counts (-1 = none)
 	int				pitch;          ///< Byte stride for texture rows
+	SDL_Rect		frame;          ///< Screen area mapped by the render target
+	SDL_Rect		shown;          ///< Screen area shown in the window
+	int				bound;          ///< Render target is the ring back slot
+	int				present;        ///< The window must be repainted
+	int				needs_redraw;   ///< The view changed and must be rendered
+	int				needs_export;   ///< The view must be exported as BMP
+	int				pan_x;          ///< Pending horizontal pan in pixels
+	int				pan_y;          ///< Pending vertical pan in pixels
+	Uint32			*palette;       ///< Colour of every escape count this frame
+	int				palette_len;    ///< Entries used in the palette
+	int				palette_size;   ///< Allocated palette entries
 	double			color_off;      ///< Phase offset for color cycling animation
 	double			zoom_factor;    ///< Current zoom level multiplier
 	t_complex		max;            ///< Maximum complex plane coordinate (top-right)
@@ -253,10 +1526,110 @@ typedef struct s_data
 	t_complex		initial_z;      ///< Starting Z value for Mandelbrot variants
 	t_complex		initial_c;      ///< Fixed C parameter for Julia sets
 	t_fractals		type;           ///< Current fractal type being rendered
-	pthread_mutex_t	pixels_mutex;   ///< Mutex protecting pixel buffer writes
+	t_iter_ctrl		iter_ctrl;      ///< Adaptive iteration controller state
+	double			iter_factor;    ///< Fixed iteration multiplier (0 = none)
+	t_tile_cache	tiles;          ///< Tile cache composing revisited views
+	t_cpu			cpu;            ///< Worker thread count and placement
+	t_program		step;           ///< Compiled step of a user formula
+	t_program		start;          ///< Compiled initial z of a user formula
+	t_tier			tier;           ///< Accuracy tier of the transcendentals
+	t_density		density;        ///< Orbit density image state
+	t_morph			morph;          ///< Interactive Julia morphing state
+	t_cycle			cycle;          ///< Continuous colour cycling state
+	t_symmetry		symmetry;       ///< Mirrored part of the current frame
+	t_session		*session;       ///< Session clock (NULL = wall clock)
+	t_split			split;          ///< Linked Julia pane
+	t_frame_ring	ring;           ///< Finished frames awaiting presentation
+	t_arena			buffers;        ///< Escape counts and frame ring slots
+	t_arena			scratch;        ///< Memory of the current round only
+	t_pipeline		pipeline;       ///< Render thread of the event loop
+	int				supersample;    ///< Adaptive supersampling flag (0 = off)
 	int				running;        ///< Application running flag (0 = exit)
 }	t_data;                         ///< Typedef of struct s_data
 
+/**
+ * @struct s_pixel_batch
+ * @brief Structure-of-arrays batch of the pixels of one render square
+ *
+ * Lane i holds pixel (area.x + i % area.w, area.y + i / area.w). Keeping the
+ * coordinates and results in separate contiguous arrays lets kernels stream
+ * over whole batches, in a layout vector units can load directly.
+ */
+typedef struct s_pixel_batch
+{
+	double		real[RENDER_TILE * RENDER_TILE];    ///< Real parts of the points
+	double		imag[RENDER_TILE * RENDER_TILE];    ///< Imaginary parts
+	int			iter[RENDER_TILE * RENDER_TILE];    ///< Escape counts
+	SDL_Rect	area;                               ///< Pixels in the batch
+	int			count;                              ///< Lanes used (w x h)
+}	t_pixel_batch;                                  ///< Typedef of struct s_pixel_batch
+
+/**
+ * @struct s_formula
+ * @brief Registry entry describing one fractal formula
+ *
+ * Everything the renderer, the command line and the colouring need to know
+ * about a formula. The kernels are expanded from the step expression by
+ * FORMULA_KERNELS, so the registry is only consulted once per batch or
+ * sample, never per iteration.
+ */
+typedef struct s_formula
+{
+	const char	*name;          ///< Command-line name
+	t_fractals	type;           ///< Registry index
+	int			julia;          ///< Sample is the initial z, c is user-given
+	int			user;           ///< Step compiled from the command line
+	t_complex	start;          ///< Initial z of the other formulas
+	int			base;           ///< Base iteration count
+	int			scaled;         ///< Escape cap follows the zoom level
+	int			hsv;            ///< HSV colouring (1) or psychedelic (0)
+	int			black_interior; ///< Bounded points drawn black
+	t_mirror	symmetry;       ///< Symmetry of every image of the formula
+	int			tiered;         ///< Escape counts depend on the accuracy tier
+	int			(*escape)(struct s_data *, t_complex);     ///< One sample
+	void		(*batch)(struct s_data *, t_pixel_batch *);///< Whole batch
+	int			(*orbit)(struct s_data *, t_complex, t_complex *);///< Orbit
+}	t_formula;                  ///< Typedef of struct s_formula
+
+/**
+ * @struct s_parser
+ * @brief State of the user formula compiler
+ */
+typedef struct s_parser
+{
+	const char	*text;      ///< Formula source
+	int			pos;        ///< Current position in the source
+	t_program	*program;   ///< Program being emitted
+	const char	*error;     ///< First error met (NULL = none)
+}	t_parser;               ///< Typedef of struct s_parser
+
+/**
+ * @struct s_vm_regs
+ * @brief Register file of the formula virtual machine
+ *
+ * Structure of arrays: register r of lane l is (re[r][l], im[r][l]), so
+ * every instruction streams over contiguous lanes.
+ */
+typedef struct s_vm_regs
+{
+	double	re[VM_MAX_REGS][VM_LANES];  ///< Real parts
+	double	im[VM_MAX_REGS][VM_LANES];  ///< Imaginary parts
+}	t_vm_regs;                          ///< Typedef of struct s_vm_regs
+
+/**
+ * @struct s_vm_lanes
+ * @brief Lane group of the formula virtual machine iterating a batch
+ */
+typedef struct s_vm_lanes
+{
+	t_vm_regs	regs;               ///< Register file of the group
+	int			pixel[VM_LANES];    ///< Batch lane computed by each lane
+	int			left[VM_LANES];     ///< Iterations left on each lane
+	int			active;             ///< Lanes in use, packed at the front
+	int			next;               ///< Next batch lane to start
+	int			cap;                ///< Iteration cap of the batch
+}	t_vm_lanes;                     ///< Typedef of struct s_vm_lanes
+
 /**
  * @struct s_thread_data
  * @brief Thread-specific data for parallel fractal rendering
@@ -268,11 +1641,177 @@ typedef struct s_data
 typedef struct s_thread_data
 {
 	t_data		*data;      ///< Pointer to shared application state
+	int			start_x;    ///< Starting column (inclusive)
+	int			end_x;      ///< Ending column (exclusive)
 	int			start_y;    ///< Starting scanline (inclusive)
 	int			end_y;      ///< Ending scanline (exclusive)
-	int			thread_id;  ///< Unique thread identifier (0 to NUM_THREADS-1)
+	int			thread_id;  ///< Unique thread identifier (0 to threads-1)
+	int			capped;     ///< Pixels that reached the iteration cap
+	int			late;       ///< Pixels that escaped in the last iterations
+	int			refined;    ///< Pixels refined by the supersampling pass
 }	t_thread_data;          ///< Typedef of struct s_thread_data
 
+/**
+ * @struct s_tile_job
+ * @brief Render of one served tile and the clients waiting for it
+ *
+ * The key holds the served zoom and tile coordinates. The clients list and
+ * the in-flight link belong to the event loop; the queue link is shared with
+ * the workers under the server lock.
+ */
+typedef struct s_tile_job
+{
+	t_tile_key			key;        ///< Fractal, parameter and z/x/y of the tile
+	t_data				data;       ///< Fractal parameters used to render it
+	int					*clients;   ///< Sockets waiting for the tile
+	int					nclients;   ///< Number of waiting sockets
+	Uint8				*body;      ///< Rendered BMP image (NULL on failure)
+	size_t				body_len;   ///< Size of the BMP image in bytes
+	struct s_tile_job	*next;      ///< Next job in flight
+	struct s_tile_job	*queue_next;///< Next job in the work or done list
+}	t_tile_job;                     ///< Typedef of struct s_tile_job
+
+/**
+ * @struct s_client
+ * @brief Connection whose request header is still being received
+ */
+typedef struct s_client
+{
+	int		fd;                         ///< Client socket (-1 = free slot)
+	int		len;                        ///< Bytes received so far
+	Uint32	since;                      ///< Tick the connection was accepted
+	char	buf[SERVER_REQUEST_MAX];    ///< Request header received so far
+}	t_client;                           ///< Typedef of struct s_client
+
+/**
+ * @struct s_server
+ * @brief State of the tile server
+ *
+ * A single event loop thread owns every socket. Workers take jobs from the
+ * queue and hand them back through the done list, writing to the wake pipe
+ * so the loop answers the waiting clients.
+ */
+typedef struct s_server
+{
+	int				listen_fd;                  ///< Listening socket
+	int				wake[2];                    ///< Worker to loop wake-up pipe
+	pthread_t		workers[MAX_THREADS];       ///< Worker pool
+	int				nworkers;                   ///< Threads in the worker pool
+	pthread_mutex_t	lock;                       ///< Protects queue and done
+	pthread_cond_t	ready;                      ///< Signals queued jobs
+	t_tile_job		*queue;                     ///< Jobs waiting for a worker
+	t_tile_job		*done;                      ///< Rendered jobs to answer
+	t_tile_job		*inflight;                  ///< Jobs queued or rendering
+	t_client		clients[SERVER_MAX_CLIENTS];///< Connections being read
+	long			rendered;                   ///< Tiles rendered
+	long			served;                     ///< Responses sent with a tile
+	t_tile_store	store;                      ///< Persistent tile store
+	pthread_mutex_t	store_lock;                 ///< Protects the store
+}	t_server;                                   ///< Typedef of struct s_server
+
+/**
+ * @struct s_dist_task
+ * @brief Poster area sent by a coordinator to a worker
+ *
+ * Carries the whole view so workers keep no state between tasks. The view is
+ * centre and horizontal span, with square pixels.
+ */
+typedef struct s_dist_task
+{
+	Uint32		magic;      ///< DIST_MAGIC
+	Uint32		id;         ///< Task index within the poster
+	t_fractals	type;       ///< Fractal to render
+	t_complex	param;      ///< Julia parameter or Mandelbrot starting z
+	t_complex	center;     ///< Complex point at the poster centre
+	double		span;       ///< Real-axis width covered by the poster
+	double		iter_factor;///< Iteration cap factor shared by every worker
+	int			width;      ///< Poster width in pixels
+	int			height;     ///< Poster height in pixels
+	SDL_Rect	area;       ///< Pixels to compute
+}	t_dist_task;            ///< Typedef of struct s_dist_task
+
+/**
+ * @struct s_dist_result
+ * @brief Header of a worker reply, followed by w x h escape counts
+ */
+typedef struct s_dist_result
+{
+	Uint32	magic;  ///< DIST_MAGIC
+	Uint32	id;     ///< Task index the counts belong to
+	int		w;      ///< Width of the computed area
+	int		h;      ///< Height of the computed area
+}	t_dist_result;  ///< Typedef of struct s_dist_result
+
+/**
+ * @struct s_dist_tile
+ * @brief Coordinator bookkeeping of one poster task
+ */
+typedef struct s_dist_tile
+{
+	SDL_Rect	area;       ///< Pixels covered by the task
+	int			done;       ///< Whether a result was shaded in
+	int			copies;     ///< Workers currently computing it
+	Uint32		started;    ///< Tick at which the first copy was sent
+}	t_dist_tile;            ///< Typedef of struct s_dist_tile
+
+/**
+ * @struct s_dist_peer
+ * @brief Worker connection of a coordinator
+ *
+ * A connection only takes tasks once its whole DIST_MAGIC greeting has
+ * arrived; until then it is polled like a worker with a pending result.
+ */
+typedef struct s_dist_peer
+{
+	int		fd;         ///< Worker socket (-1 = free slot)
+	int		task;       ///< Task being computed (-1 = idle)
+	int		completed;  ///< Results received from this worker
+	Uint32	magic;      ///< Greeting received so far
+	int		greeted;    ///< Bytes of the greeting received
+	Uint32	since;      ///< Tick the connection was accepted
+}	t_dist_peer;        ///< Typedef of struct s_dist_peer
+
+/**
+ * @struct s_coordinator
+ * @brief State of a distributed poster render
+ */
+typedef struct s_coordinator
+{
+	int			listen_fd;                  ///< Socket workers connect to
+	t_dist_task	job;                        ///< View shared by every task
+	t_data		data;                       ///< Colouring state for shading
+	t_dist_tile	*tiles;                     ///< Poster tasks
+	int			ntiles;                     ///< Number of tasks
+	int			finished;                   ///< Tasks shaded into the image
+	int			reissued;                   ///< Backup copies sent
+	int			failed;                     ///< Tasks lost with a worker
+	int			workers;                    ///< Workers that connected
+	Uint32		task_ms;                    ///< Total time of finished tasks
+	int			*counts;                    ///< Receive buffer of a result
+	Uint8		*image;                     ///< BMP file being assembled
+	t_dist_peer	peers[DIST_MAX_WORKERS];    ///< Worker connections
+}	t_coordinator;                          ///< Typedef of struct s_coordinator
+
+/**
+ * @struct s_check
+ * @brief State of the differential render check
+ *
+ * Each view is rendered headless, without texture or palette, into the
+ * escape count buffer of data; oracle holds the counts of the compared
+ * area given by the plain scalar iteration.
+ */
+typedef struct s_check
+{
+	t_data		data;       ///< Headless state of the view under test
+	SDL_Rect	area;       ///< Screen area compared
+	int			*oracle;    ///< Reference escape counts of the area
+	Uint8		*image;     ///< BMP file of a difference image
+	char		view[32];   ///< Name of the view in reports and file names
+	Uint64		rng;        ///< State of the view and operand generator
+	int			compared;   ///< Comparisons run
+	int			failed;     ///< Comparisons beyond their tolerance
+}	t_check;                ///< Typedef of struct s_check
+
 /**
  * @defgroup utils Utility Functions
  * @brief Helper functions for rendering, event handling, and string operations
@@ -282,10 +1821,15 @@ typedef struct s_thread_data
  * input, and string validation for command-line argument parsing.
  *
  * @section utils_features Features
- * - Thread-safe pixel writing with mutex synchronization
+ * - Lock-free pixel writing into a triple-buffered frame ring
+ * - Render thread overlapping computation with presentation
  * - HSV and psychedelic color mapping algorithms
- * - Interactive zoom with mouse wheel support
+ * - Interactive zoom with mouse wheel support, coalesced into one redraw
+ * - Drag and arrow-key panning by whole pixels
+ * - Per-frame colour palette shared by all workers
  * - Keyboard event handling for application control
+ * - Anti-aliased BMP export of the current view
+ * - Worker count from the affinity mask and cgroup quota, optional pinning
  * - String comparison for fractal type validation
  *
  * @section utils_usage Usage
@@ -295,13 +1839,56 @@ typedef struct s_thread_data
  */
 
 void		my_mlx_pixel_put(t_data *data, t_vector2 pos, int color);
-int			get_color_hsv(int iter, int max_iter);
+int			build_palette(t_data *data);
+int			palette_color(t_data *data, int dives);
+int			frame_begin(t_data *data);
+void		frame_end(t_data *data);
+int			frame_ring_init(t_frame_ring *ring, t_arena *arena);
+int			arena_init(t_arena *arena, size_t bytes, int huge);
+void		*arena_alloc(t_arena *arena, size_t bytes);
+void		arena_reset(t_arena *arena);
+void		arena_report(const char *name, t_arena *arena);
+void		arena_free(t_arena *arena);
+int			frame_acquire(t_data *data);
+void		pipeline_start(t_data *data, int (*job)(t_data *));
+void		pipeline_post(t_data *data);
+int			pipeline_busy(t_data *data);
+void		pipeline_wait(t_data *data, int ms);
+void		pipeline_stop(t_data *data);
+void		session_init(t_session *session);
+Uint32		session_ticks(t_data *data);
+void		session_tick(t_data *data);
+void		session_round(t_data *data);
+int			session_record(t_session *session, const char *path, int argc,
+				char **argv);
+void		session_log(t_data *data, const SDL_Event *event);
+void		session_log_round(t_data *data);
+t_vector2	session_mouse(t_data *data);
+int			session_load(t_session *session, const char *path);
+int			session_next(t_session *session, SDL_Event *event,
+				t_record *record);
+void		session_verify(t_data *data, const t_record *record, double ms);
+int			session_summary(t_session *session);
+int			get_color_hsv(int iter, int max_iter, double phase);
 int			psychedelic_color(int iter, double phase, int iterations);
+int			density_color(double t);
 int			key_handler(SDL_Keycode keycode, t_data *vars);
 int			zoom(Uint8 mousecode, int x, int y, t_data *img);
+int			wheel_handler(SDL_MouseWheelEvent *wheel, t_vector2 mouse,
+				t_data *vars);
+int			pan_view(t_data *data, int dx, int dy);
 int			is_mandelbrot(char *type);
 int			is_julia(char *type);
+int			fractal_setup(t_data *data, char **args);
 int			close_window(t_data *vars);
+int			export_image(t_data *data);
+void		put_le32(Uint8 *out, Uint32 value);
+size_t		bmp_header(Uint8 *out, int width, int height);
+void		cpu_detect(t_cpu *cpu);
+int			cpu_options(t_cpu *cpu, int argc, char **argv);
+void		cpu_thread_attr(const t_cpu *cpu, pthread_attr_t *attr,
+				int thread_id);
+void		*first_touch_threaded(void *arg);
 
 /**
  * @defgroup complex_ops Complex Number Operations
@@ -318,6 +1905,9 @@ int			close_window(t_data *vars);
  * - Complex inversion: 1/(a+bi) = (a-bi)/(a²+b²)
  * - Hyperbolic sine: sinh(a+bi) = sinh(a)cos(b) + icosh(a)sin(b)
  * - Modulus calculation for divergence detection: |z| = √(a²+b²)
+ * - Fused fast sinh/cosh and sin/cos for the preview accuracy tier
+ * - Batch versions over structure-of-arrays operands, with scalar and AVX2
+ *   implementations picked at run time from the CPU features
  *
  * @section complex_usage Usage
  * These functions are the mathematical foundation for all fractal iterations.
@@ -332,6 +1922,10 @@ t_complex	sinh_complx(t_complex num);
 t_complex	sum_complx(t_complex a, t_complex b);
 t_complex	div_complx(t_complex a, t_complex b);
 t_complex	multiply_complx(t_complex a, t_complex b);
+const t_complex_ops	*complex_ops(void);
+const t_complex_ops	*complex_ops_scalar(void);
+const t_complex_ops	*complex_ops_avx2(void);
+void		complex_batch_sinh(t_complex_soa dst, t_complex_soa a, int n);
 
 /**
  * @defgroup fractal_render Fractal Rendering Engine
@@ -339,31 +1933,182 @@ t_complex	multiply_complx(t_complex a, t_complex b);
  *
  * @details Implements the main rendering pipeline including thread management,
  * coordinate mapping from screen to complex plane, and fractal-specific
- * iteration functions. Each fractal type has its own drawing function with
- * a unique iteration formula and divergence detection logic.
+ * iteration functions. Each fractal type has its own escape and colouring
+ * functions with a unique iteration formula and divergence detection logic.
  *
  * @section render_features Features
  * - Multi-threaded parallel rendering with POSIX threads
  * - Dynamic iteration count based on zoom level
+ * - Optional time-budgeted iteration controller with idle refinement
+ * - Adaptive supersampling of pixels on sharp escape count transitions
  * - Screen-to-complex-plane coordinate transformation
- * - Separate rendering functions for each fractal type
- * - Thread-safe pixel buffer updates with mutex protection
+ * - Formula registry expanded into one specialized inline kernel per formula
+ * - User formulas compiled to register bytecode run by a lane-parallel VM
+ * - Workers write straight into the frame ring; only the rendered area of a
+ *   frame is uploaded to the texture
+ * - Squares visited in Morton order and computed as structure-of-arrays batches
+ * - Pans recompute only the newly exposed strips of the view
+ * - Views across an axis of symmetry compute one side and mirror the other
+ * - Progressive orbit density images with per-thread histograms and
+ *   importance-sampled starting points
+ * - Julia constant following the pointer, with cancellable coarse previews
+ * - Linked Mandelbrot and Julia panes sharing the worker threads
+ * - Differential check of the optimized paths against a scalar reference
  * - Adaptive divergence limits per fractal variant
  *
  * @section render_usage Usage
  * The redraw_fractal function is called whenever the view changes (zoom, pan).
- * It spawns NUM_THREADS workers, each computing a horizontal strip of the
+ * It spawns one worker per detected CPU, each computing a horizontal strip of the
  * image. Each worker maps screen pixels to complex coordinates and calls the
- * appropriate draw function based on the fractal type.
+ * appropriate escape and colouring functions based on the fractal type.
  */
 
 int			calculate_iterations(t_data *data, int max_iter);
+t_complex	screen_to_complex(t_data *data, double x, double y);
+int			fractal_escape(t_data *data, t_complex point);
+int			fractal_shade(t_data *data, int dives);
+int			iteration_cap(t_data *data);
+void		run_threaded(t_data *data, SDL_Rect area, void *(*routine)(void *),
+				t_thread_data *thread_data);
 void		redraw_fractal(t_data *data);
+void		pan_fractal(t_data *data);
 void		*render_fractal_threaded(void *arg);
-void		draw_julia(t_data *img, t_complex z, t_vector2 pos);
-void		draw_mandelbrot(t_data *img, t_complex c, t_vector2 pos);
-void		draw_eye_mandelbrot(t_data *img, t_complex c, t_vector2 pos);
-void		draw_sinh_mandelbrot(t_data *img, t_complex c, t_vector2 pos);
-void		draw_dragon_mandelbrot(t_data *img, t_complex c, t_vector2 pos);
+void		count_escape(t_thread_data *thread_data, int dives, int cap);
+int			symmetry_align(t_data *data, SDL_Rect area);
+void		symmetry_render(t_data *data, SDL_Rect area,
+				t_thread_data *thread_data);
+t_vector2	morton_decode(unsigned int index);
+void		batch_gather(t_data *data, SDL_Rect area, t_pixel_batch *batch);
+void		fractal_escape_batch(t_data *data, t_pixel_batch *batch);
+int			supersample_fractal(t_data *data);
+const t_formula	*fractal_formula(t_fractals type);
+const t_formula	*formula_by_name(const char *name);
+int			vm_compile(t_program *program, const char *text);
+t_complex	vm_apply(int op, t_complex a, t_complex b);
+int			vm_escape(t_data *data, t_complex point);
+void		vm_batch(t_data *data, t_pixel_batch *batch);
+void		iter_ctrl_init(t_data *data);
+void		iter_ctrl_toggle(t_data *data);
+void		iter_ctrl_input(t_data *data);
+void		iter_ctrl_feedback(t_data *data, double ms, int capped, int late);
+int			iter_ctrl_due(t_data *data);
+int			iter_ctrl_refine(t_data *data);
+void		*recolor_threaded(void *arg);
+void		morph_init(t_morph *morph);
+void		morph_toggle(t_data *data);
+void		morph_follow(t_data *data, int x, int y);
+int			morph_preview(t_data *data);
+int			morph_due(t_data *data);
+int			morph_settle(t_data *data);
+void		cycle_init(t_cycle *cycle);
+void		cycle_toggle(t_data *data);
+int			cycle_due(t_data *data);
+int			cycle_step(t_data *data);
+void		split_toggle(t_data *data);
+void		split_close(t_data *data);
+t_data		*split_target(t_data *data, int *x);
+void		split_follow(t_data *data, int x, int y);
+int			split_refresh(t_data *data);
+int			split_present(t_data *data);
+void		density_init(t_density *density);
+void		density_toggle(t_data *data);
+void		density_reset(t_data *data);
+int			density_refine(t_data *data);
+void		density_free(t_density *density);
+int			render_check(const t_cpu *cpu, int argc, char **argv);
+
+/**
+ * @defgroup tiles Tile Cache
+ * @brief Reuse of escape counts across zoom levels and pans
+ *
+ * @details Escape counts are stored in square tiles laid out on a quadtree:
+ * level L splits the plane into tiles of side TILE_ROOT_SPAN / 2^L. A view
+ * is rendered at the level whose sample spacing is closest to its pixel
+ * spacing, its pixels looking up the nearest sample of the covering tiles.
+ * Tiles already cached are reused; only the missing ones are computed, so
+ * zooming back out to a visited view or panning over it costs no iterations.
+ *
+ * @section tiles_features Features
+ * - Tiles keyed by fractal type, parameter, level and tile coordinates
+ * - Iteration cap fixed per level so tiles are valid for every view
+ * - LRU eviction above TILE_CACHE_MB, never evicting the visible tiles
+ * - Persistent memory-mapped store shared by every run, read in place
+ * - Missing tiles computed in parallel by the worker threads
+ *
+ * @section tiles_usage Usage
+ * Toggled with the T key, which also opens the persistent store at
+ * TILE_STORE_PATH. Tiles missing from memory are looked up in the store
+ * before being computed, and computed tiles are written to it, so views
+ * rendered by earlier runs, by exports made in tile mode or by the tile
+ * server start warm. While enabled, redraw_fractal composes the view from
+ * tiles and the adaptive iteration controller is bypassed, since the
+ * iteration cap depends on the tile level. Exports outside tile mode and
+ * distributed renders, which sample the pixel grid of their image rather
+ * than the tile grid, do not use the store.
+ */
+
+void		tile_cache_init(t_tile_cache *cache, size_t limit);
+t_tile		*tile_cache_find(t_tile_cache *cache, const t_tile_key *key);
+t_tile		*tile_cache_insert(t_tile_cache *cache, const t_tile_key *key,
+				int slot);
+void		tile_cache_remove(t_tile_cache *cache, t_tile *tile);
+Uint64		tile_key_hash(const t_tile_key *key);
+int			tile_key_equal(const t_tile_key *a, const t_tile_key *b);
+int			tile_store_open(t_tile_store *store, const char *path);
+void		tile_store_close(t_tile_store *store);
+void		tile_store_tick(t_tile_store *store);
+int			tile_store_find(t_tile_store *store, const t_tile_key *key);
+int			tile_store_reserve(t_tile_store *store, const t_tile_key *key);
+void		tile_store_touch(t_tile_store *store, int slot);
+void		tile_store_commit(t_tile_store *store, int slot);
+int			*tile_store_samples(t_tile_store *store, int slot);
+void		tile_cache_trim(t_tile_cache *cache);
+void		tile_cache_free(t_tile_cache *cache);
+double		tile_level_factor(int level);
+int			tile_key_tier(const t_data *data);
+void		tile_mode_toggle(t_data *data);
+int			tile_fetch(t_data *data);
+void		*tile_compose_threaded(void *arg);
+void		tile_samples(t_data *data, int level, const long *origin, int size,
+				int *out);
+
+/**
+ * @defgroup server Tile Server
+ * @brief Headless rendering of tiles for other programs over sockets
+ *
+ * @details Started with "./fractol serve [address]", the tile server answers
+ * HTTP GET requests for slippy-map tiles, "/<fractal>/<z>/<x>/<y>.bmp", so
+ * web map viewers can browse every fractal. Tiles are rendered on demand by
+ * a pool of worker threads with the same sample grid and iteration caps as
+ * the tile cache.
+ *
+ * @section server_features Features
+ * - TCP or Unix domain sockets ("tcp:[host:]port" or "unix:path")
+ * - Concurrent requests for the same tile merged into one render
+ * - One event loop thread for every client, one pool of render workers
+ * - Plain HTTP/1.0 with BMP bodies, testable with curl on localhost
+ *
+ * @section server_usage Usage
+ * ./fractol serve tcp:8080, then GET
+ * http://127.0.0.1:8080/julia/-0.8/0.156/3/4/2.bmp. Zoom 0 is one tile
+ * covering the TILE_ROOT_SPAN square centred on the origin.
+ *
+ * @section server_distributed Distributed Rendering
+ * "./fractol coordinate <address> <out.bmp> <width> <height> <re> <im>
+ * <span> <fractal> [re im]" renders a poster on the workers started with
+ * "./fractol worker <address> [processes]" on any number of hosts. Workers
+ * pull one DIST_TILE_PX square at a time and return raw escape counts, which
+ * the coordinator shades and writes out. Tasks of failed workers are
+ * re-issued and slow ones get a backup copy. Messages use the native layout,
+ * so every peer must run the same build.
+ */
+
+int			tile_server(const char *address, const t_cpu *cpu);
+int			net_listen(const char *address);
+int			net_send_all(int fd, const void *buffer, size_t len);
+int			net_connect(const char *address);
+int			net_recv_all(int fd, void *buffer, size_t len);
+int			dist_worker(const char *address, int processes);
+int			dist_coordinator(int argc, char **argv);
 
 #endif
@@ -0,0 +1,228 @@
+/**
+ * @file complex_batch.c
+ * @brief Scalar batch complex operations and run-time implementation choice
+ *
+ * @details The scalar operations apply the inline cx_ helpers element by
+ * element. They are the reference the vector implementations must match
+ * bit for bit, and the fallback on CPUs without those instruction sets.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "formula.h"
+
+/**
+ * @brief Adds two arrays of complex numbers, one element at a time
+ *
+ * @ingroup complex_ops
+ *
+ * @param[out] dst Sums
+ * @param[in] a First terms
+ * @param[in] b Second terms
+ * @param[in] n Number of elements
+ */
+static void	scalar_add(t_complex_soa dst, t_complex_soa a, t_complex_soa b,
+				int n)
+{
+	t_complex	r;
+	int			i;
+
+	i = -1;
+	while (++i < n)
+	{
+		r = cx_add((t_complex){a.real[i], a.imag[i]},
+				(t_complex){b.real[i], b.imag[i]});
+		dst.real[i] = r.real;
+		dst.imag[i] = r.imag;
+	}
+}
+
+/**
+ * @brief Subtracts two arrays of complex numbers, one element at a time
+ *
+ * @ingroup complex_ops
+ *
+ * @param[out] dst Differences
+ * @param[in] a Minuends
+ * @param[in] b Subtrahends
+ * @param[in] n Number of elements
+ */
+static void	scalar_sub(t_complex_soa dst, t_complex_soa a, t_complex_soa b,
+				int n)
+{
+	int	i;
+
+	i = -1;
+	while (++i < n)
+	{
+		dst.real[i] = a.real[i] - b.real[i];
+		dst.imag[i] = a.imag[i] - b.imag[i];
+	}
+}
+
+/**
+ * @brief Multiplies two arrays of complex numbers, one element at a time
+ *
+ * @ingroup complex_ops
+ *
+ * @param[out] dst Products
+ * @param[in] a First factors
+ * @param[in] b Second factors
+ * @param[in] n Number of elements
+ */
+static void	scalar_mul(t_complex_soa dst, t_complex_soa a, t_complex_soa b,
+				int n)
+{
+	t_complex	r;
+	int			i;
+
+	i = -1;
+	while (++i < n)
+	{
+		r = cx_mul((t_complex){a.real[i], a.imag[i]},
+				(t_complex){b.real[i], b.imag[i]});
+		dst.real[i] = r.real;
+		dst.imag[i] = r.imag;
+	}
+}
+
+/**
+ * @brief Divides two arrays of complex numbers, one element at a time
+ *
+ * @ingroup complex_ops
+ *
+ * @param[out] dst Quotients
+ * @param[in] a Dividends
+ * @param[in] b Divisors
+ * @param[in] n Number of elements
+ */
+static void	scalar_div(t_complex_soa dst, t_complex_soa a, t_complex_soa b,
+				int n)
+{
+	t_complex	r;
+	int			i;
+
+	i = -1;
+	while (++i < n)
+	{
+		r = cx_div((t_complex){a.real[i], a.imag[i]},
+				(t_complex){b.real[i], b.imag[i]});
+		dst.real[i] = r.real;
+		dst.imag[i] = r.imag;
+	}
+}
+
+/**
+ * @brief Inverts an array of complex numbers, one element at a time
+ *
+ * @ingroup complex_ops
+ *
+ * @param[out] dst Reciprocals
+ * @param[in] a Numbers to invert
+ * @param[in] n Number of elements
+ */
+static void	scalar_inv(t_complex_soa dst, t_complex_soa a, int n)
+{
+	t_complex	r;
+	int			i;
+
+	i = -1;
+	while (++i < n)
+	{
+		r = cx_inv((t_complex){a.real[i], a.imag[i]});
+		dst.real[i] = r.real;
+		dst.imag[i] = r.imag;
+	}
+}
+
+/**
+ * @brief Hyperbolic sine of an array of complex numbers
+ *
+ * @details Also used by the vector implementations: the C library has no
+ * vector sinh, and its scalar one keeps every image reproducible.
+ *
+ * @ingroup complex_ops
+ *
+ * @param[out] dst Hyperbolic sines
+ * @param[in] a Arguments
+ * @param[in] n Number of elements
+ */
+void	complex_batch_sinh(t_complex_soa dst, t_complex_soa a, int n)
+{
+	t_complex	r;
+	int			i;
+
+	i = -1;
+	while (++i < n)
+	{
+		r = cx_sinh((t_complex){a.real[i], a.imag[i]});
+		dst.real[i] = r.real;
+		dst.imag[i] = r.imag;
+	}
+}
+
+/**
+ * @brief Squared moduli of an array of complex numbers
+ *
+ * @ingroup complex_ops
+ *
+ * @param[out] dst Squared moduli
+ * @param[in] a Complex numbers
+ * @param[in] n Number of elements
+ */
+static void	scalar_norm(double *dst, t_complex_soa a, int n)
+{
+	int	i;
+
+	i = -1;
+	while (++i < n)
+		dst[i] = cx_norm((t_complex){a.real[i], a.imag[i]});
+}
+
+/**
+ * @brief Returns the scalar batch operations
+ *
+ * @ingroup complex_ops
+ *
+ * @return const t_complex_ops* Operations available on every CPU
+ */
+const t_complex_ops	*complex_ops_scalar(void)
+{
+	static const t_complex_ops	ops = {"scalar", scalar_add, scalar_sub,
+		scalar_mul, scalar_div, scalar_inv, complex_batch_sinh, scalar_norm};
+
+	return (&ops);
+}
+
+static const t_complex_ops	*g_complex_ops;
+
+/**
+ * @brief Picks the batch operations from the features the CPU reports
+ *
+ * @ingroup complex_ops
+ */
+static void	complex_ops_select(void)
+{
+	g_complex_ops = complex_ops_avx2();
+	if (!g_complex_ops)
+		g_complex_ops = complex_ops_scalar();
+}
+
+/**
+ * @brief Returns the fastest batch operations the CPU supports
+ *
+ * @details The choice is made once, by whichever thread asks first, and
+ * kept for the rest of the run.
+ *
+ * @ingroup complex_ops
+ *
+ * @return const t_complex_ops* Batch operations to use
+ */
+const t_complex_ops	*complex_ops(void)
+{
+	static pthread_once_t	once = PTHREAD_ONCE_INIT;
+
+	pthread_once(&once, complex_ops_select);
+	return (g_complex_ops);
+}
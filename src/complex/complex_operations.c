@@ -6,7 +6,7 @@
  * @date 2025-11-03
  */
 
-#include "fract_ol.h"
+#include "formula.h"
 
 /**
  * @brief Multiplies two complex numbers
@@ -24,11 +24,7 @@
  */
 t_complex	multiply_complx(t_complex a, t_complex b)
 {
-	t_complex	result;
-
-	result.real = (a.real * b.real) - (a.imag * b.imag);
-	result.imag = (a.real * b.imag) + (a.imag * b.real);
-	return (result);
+	return (cx_mul(a, b));
 }
 
 /**
@@ -47,11 +43,7 @@ t_complex	multiply_complx(t_complex a, t_complex b)
  */
 t_complex	sum_complx(t_complex a, t_complex b)
 {
-	t_complex	result;
-
-	result.real = (a.real + b.real);
-	result.imag = (a.imag + b.imag);
-	return (result);
+	return (cx_add(a, b));
 }
 
 /**
@@ -73,15 +65,7 @@ t_complex	sum_complx(t_complex a, t_complex b)
  */
 t_complex	div_complx(t_complex a, t_complex b)
 {
-	t_complex	result;
-	double		den;
-
-	den = (b.real * b.real) + (b.imag * b.imag);
-
-	result.real = (a.real * b.real + a.imag * b.imag) / den;
-
-	result.imag = (a.imag * b.real - a.real * b.imag) / den;
-	return (result);
+	return (cx_div(a, b));
 }
 
 /**
@@ -102,13 +86,7 @@ t_complex	div_complx(t_complex a, t_complex b)
  */
 t_complex	inv_complx(t_complex a)
 {
-	t_complex	result;
-	double		den;
-
-	den = (a.real * a.real) + (a.imag * a.imag);
-	result.real = a.real / den;
-	result.imag = -a.imag / den;
-	return (result);
+	return (cx_inv(a));
 }
 
 /**
@@ -127,5 +105,5 @@ t_complex	inv_complx(t_complex a)
  */
 double	complx_module(t_complex num)
 {
-	return (sqrt((num.real * num.real) + (num.imag * num.imag)));
+	return (sqrt(cx_norm(num)));
 }
@@ -6,7 +6,7 @@
  * @date 2025-11-03
  */
 
-#include "fract_ol.h"
+#include "formula.h"
 
 /**
  * @brief Computes the hyperbolic sine of a complex number
@@ -25,10 +25,5 @@
  */
 t_complex	sinh_complx(t_complex num)
 {
-	t_complex	result;
-
-	result.real = sinh(num.real) * cos(num.imag);
-
-	result.imag = cosh(num.real) * sin(num.imag);
-	return (result);
+	return (cx_sinh(num));
 }
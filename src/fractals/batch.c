@@ -0,0 +1,108 @@
+/**
+ * @file batch.c
+ * @brief Morton-ordered render squares and structure-of-arrays pixel batches
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Gathers the even bits of a Morton index into an integer
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] bits Morton index shifted so the wanted bits are the even ones
+ *
+ * @return int Coordinate made of those bits
+ */
+static int	compact_bits(unsigned int bits)
+{
+	bits &= 0x55555555u;
+	bits = (bits | (bits >> 1)) & 0x33333333u;
+	bits = (bits | (bits >> 2)) & 0x0F0F0F0Fu;
+	bits = (bits | (bits >> 4)) & 0x00FF00FFu;
+	bits = (bits | (bits >> 8)) & 0x0000FFFFu;
+	return ((int)bits);
+}
+
+/**
+ * @brief Returns the square visited at a position of the Z-order curve
+ *
+ * @details Walking indices 0, 1, 2... visits squares in Morton order:
+ * 2x2 blocks, then 2x2 blocks of those, and so on. Neighbouring squares are
+ * rendered close together in time, so the rows of the iteration buffer and
+ * texture they share are still cached.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] index Position on the curve
+ *
+ * @return t_vector2 Column and row of the square
+ */
+t_vector2	morton_decode(unsigned int index)
+{
+	t_vector2	square;
+
+	square.x = compact_bits(index);
+	square.y = compact_bits(index >> 1);
+	return (square);
+}
+
+/**
+ * @brief Fills a batch with the complex points of a screen area
+ *
+ * @details The real part only depends on the column and the imaginary part
+ * on the row, so each is mapped once per column or row with
+ * screen_to_complex() and then spread over the lanes. The points are exactly
+ * the ones a per-pixel mapping gives.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with viewing parameters
+ * @param[in] area Screen area of at most RENDER_TILE x RENDER_TILE pixels
+ * @param[out] batch Batch receiving the points
+ */
+void	batch_gather(t_data *data, SDL_Rect area, t_pixel_batch *batch)
+{
+	double	real[RENDER_TILE];
+	double	imag;
+	int		lane;
+	int		x;
+	int		y;
+
+	batch->area = area;
+	batch->count = area.w * area.h;
+	x = -1;
+	while (++x < area.w)
+		real[x] = screen_to_complex(data, area.x + x, area.y).real;
+	lane = 0;
+	y = -1;
+	while (++y < area.h)
+	{
+		imag = screen_to_complex(data, area.x, area.y + y).imag;
+		x = -1;
+		while (++x < area.w)
+		{
+			batch->real[lane] = real[x];
+			batch->imag[lane++] = imag;
+		}
+	}
+}
+
+/**
+ * @brief Computes the escape counts of every lane of a batch
+ *
+ * @details The formula is resolved once per batch rather than once per
+ * pixel, then its specialized batch kernel runs over the lanes back to back.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the fractal type
+ * @param[in,out] batch Batch of points, receiving their escape counts
+ */
+void	fractal_escape_batch(t_data *data, t_pixel_batch *batch)
+{
+	fractal_formula(data->type)->batch(data, batch);
+}
@@ -0,0 +1,617 @@
+/**
+ * @file check.c
+ * @brief Differential check of the optimized render paths
+ *
+ * @details Renders fixed and seeded random views of every built-in formula
+ * headless and compares each optimized path pixel by pixel with a plain
+ * scalar iteration written from the out-of-line complex operations: the
+ * batch kernels at the exact tier, the preview tier with its fused
+ * transcendentals, the formula VM running the same formula and, on views
+ * across an axis of symmetry, the mirrored render. The batch
+ * complex operations are compared bit for bit with their scalar versions.
+ * Each comparison reports the pixels that differ and the largest escape
+ * count deviation, against a tolerance set per formula and path; paths
+ * that differ also leave a difference image behind.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Returns a uniform random number in [0, 1)
+ *
+ * @details xorshift64* generator, so a seed always gives the same views.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] state Generator state, never 0
+ *
+ * @return double Uniform random number
+ */
+static double	check_unit(Uint64 *state)
+{
+	Uint64	x;
+
+	x = *state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+	return ((double)((x * 0x2545F4914F6CDD1DULL) >> 11)
+		* (1.0 / 9007199254740992.0));
+}
+
+/**
+ * @brief Applies one step of a built-in formula with the scalar operations
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] type Fractal type
+ * @param[in] z Current value
+ * @param[in] c Constant of the iteration
+ *
+ * @return t_complex Next value of z
+ */
+static t_complex	check_step(t_fractals type, t_complex z, t_complex c)
+{
+	if (type == SINH_MANDELBROT)
+		return (sinh_complx(div_complx(z, c)));
+	if (type == EYE_MANDELBROT)
+		return (sum_complx(multiply_complx(multiply_complx(z, z), z),
+				inv_complx(c)));
+	if (type == DRAGON_MANDELBROT)
+		return (sum_complx(sinh_complx(z),
+				inv_complx(multiply_complx(c, c))));
+	return (sum_complx(multiply_complx(z, z), c));
+}
+
+/**
+ * @brief Reference escape count of one sample
+ *
+ * @details Follows the contract of the formula kernels: the iterations
+ * left when |z| exceeds the bailout radius, or 0 for samples that never do.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to the state of the view
+ * @param[in] point Sample
+ *
+ * @return int Escape count
+ */
+static int	check_diverge(t_data *data, t_complex point)
+{
+	t_complex	z;
+	t_complex	c;
+	double		bailout;
+	int			iter;
+
+	z = data->initial_z;
+	c = point;
+	if (fractal_formula(data->type)->julia)
+	{
+		z = point;
+		c = data->initial_c;
+	}
+	bailout = 2.0;
+	if (data->type == DRAGON_MANDELBROT)
+		bailout = 60.0;
+	iter = iteration_cap(data);
+	while (iter--)
+	{
+		z = check_step(data->type, z, c);
+		if (z.real * z.real + z.imag * z.imag > bailout * bailout)
+			return (iter);
+	}
+	return (0);
+}
+
+/**
+ * @brief Thread worker computing the reference escape counts of its strip
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] arg Pointer to the t_thread_data of this worker
+ *
+ * @return void* Always NULL
+ */
+static void	*check_oracle_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+	int				x;
+	int				y;
+
+	thread_data = (t_thread_data *)arg;
+	y = thread_data->start_y - 1;
+	while (++y < thread_data->end_y)
+	{
+		x = thread_data->start_x - 1;
+		while (++x < thread_data->end_x)
+			thread_data->data->iters[y * SCREEN_WIDTH + x] = check_diverge(
+					thread_data->data, screen_to_complex(thread_data->data, x,
+						y));
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Renders the compared area with one path into the escape counts
+ *
+ * @details The oracle runs when reference is set, the regular renderer
+ * otherwise. Without a render target, only escape counts are written.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] check Check state with the view to render
+ * @param[in] reference Whether to run the scalar reference
+ */
+static void	check_render(t_check *check, int reference)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+	int				y;
+
+	if (!reference)
+	{
+		run_threaded(&check->data, check->area, render_fractal_threaded,
+			thread_data);
+		return ;
+	}
+	run_threaded(&check->data, check->area, check_oracle_threaded,
+		thread_data);
+	y = -1;
+	while (++y < check->area.h)
+		mem_copy(check->oracle + y * check->area.w, check->data.iters
+			+ (check->area.y + y) * SCREEN_WIDTH + check->area.x,
+			check->area.w * sizeof(int));
+}
+
+/**
+ * @brief Writes the difference image of a failed or inexact comparison
+ *
+ * @details Matching pixels are shaded in grey by their reference escape
+ * count; differing ones in red, brighter for larger deviations.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] check Check state with both sets of escape counts
+ * @param[in] path Name of the compared path
+ */
+static void	check_image(t_check *check, const char *path)
+{
+	char	name[96];
+	size_t	size;
+	int		cap;
+	int		i;
+	int		d;
+	int		fd;
+
+	snprintf(name, sizeof(name), "check_%s_%s_%s.bmp",
+		fractal_formula(check->data.type)->name, check->view, path);
+	size = bmp_header(check->image, check->area.w, check->area.h);
+	cap = fmax(iteration_cap(&check->data), 1);
+	i = -1;
+	while (++i < check->area.w * check->area.h)
+	{
+		d = abs(check->data.iters[(check->area.y + i / check->area.w)
+				* SCREEN_WIDTH + check->area.x + i % check->area.w]
+				- check->oracle[i]);
+		if (d)
+			put_le32(check->image + BMP_HEADER_SIZE + i * 4, 0xFF800000
+				+ ((Uint32)fmin(127, d) << 16));
+		else
+			put_le32(check->image + BMP_HEADER_SIZE + i * 4, 0xFF000000
+				+ 0x010101 * (Uint32)(check->oracle[i] * 255 / cap));
+	}
+	fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0 || write(fd, check->image, size) != (ssize_t)size)
+		print_format("\033[0;91mCannot write %s\n\033[0;39m", name);
+	if (fd >= 0)
+		close(fd);
+}
+
+/**
+ * @brief Compares the escape counts of a path with the reference
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] check Check state with both sets of escape counts
+ * @param[in] path Name of the compared path
+ * @param[in] tolerance Share of pixels allowed to differ
+ */
+static void	check_compare(t_check *check, const char *path, double tolerance)
+{
+	char	line[160];
+	int		differ;
+	int		deviation;
+	int		d;
+	int		i;
+
+	differ = 0;
+	deviation = 0;
+	i = -1;
+	while (++i < check->area.w * check->area.h)
+	{
+		d = abs(check->data.iters[(check->area.y + i / check->area.w)
+				* SCREEN_WIDTH + check->area.x + i % check->area.w]
+				- check->oracle[i]);
+		differ += (d != 0);
+		deviation = fmax(deviation, d);
+	}
+	snprintf(line, sizeof(line), "%-10s %-8s %-8s %6d / %d differ, max "
+		"deviation %d", fractal_formula(check->data.type)->name, check->view,
+		path, differ, check->area.w * check->area.h, deviation);
+	check->compared++;
+	if (differ > tolerance * check->area.w * check->area.h)
+	{
+		check->failed++;
+		print_format("\033[0;91m%s  FAIL\n\033[0;39m", line);
+	}
+	else
+		print_format("\033[0;92m%s  ok\n\033[0;39m", line);
+	if (differ)
+		check_image(check, path);
+}
+
+/**
+ * @brief Share of pixels the preview tier may change, per formula
+ *
+ * @details Formulas without transcendentals do not depend on the tier.
+ * The others iterate chaotic maps, where the last-bit differences of the
+ * fused functions change the escape count of pixels on the edge of the set,
+ * by any amount. The deep orbits of the dragon change up to a few percent
+ * of the pixels of zoomed views.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] type Fractal type
+ *
+ * @return double Share of pixels allowed to differ from the reference
+ */
+static double	check_tolerance(t_fractals type)
+{
+	if (type == SINH_MANDELBROT)
+		return (0.01);
+	if (type == DRAGON_MANDELBROT)
+		return (0.1);
+	return (0);
+}
+
+/**
+ * @brief Compares the formula VM with the reference on the current view
+ *
+ * @details The formula is compiled from its text form, so the check covers
+ * the compiler and its constant folding as well as the VM. Only formulas
+ * whose iteration cap the VM reproduces are covered.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] check Check state with the reference computed
+ */
+static void	check_vm(t_check *check)
+{
+	t_fractals	type;
+	char		step[96];
+	const char	*start;
+
+	type = check->data.type;
+	start = "0";
+	if (type == MANDELBROT)
+		snprintf(step, sizeof(step), "z*z+c");
+	else if (type == EYE_MANDELBROT)
+		snprintf(step, sizeof(step), "z*z*z+1/c");
+	else if (type == JULIA)
+	{
+		snprintf(step, sizeof(step), "z*z+(%.17g+%.17g*i)",
+			check->data.initial_c.real, check->data.initial_c.imag);
+		start = "c";
+	}
+	else
+		return ;
+	if (vm_compile(&check->data.step, step)
+		|| vm_compile(&check->data.start, start))
+	{
+		check->failed++;
+		return ;
+	}
+	check->data.type = USER_FORMULA;
+	check_render(check, 0);
+	check->data.type = type;
+	check_compare(check, "vm", 0);
+}
+
+/**
+ * @brief Compares the mirrored render with the reference
+ *
+ * @details Runs only on views across an axis of symmetry of the formula,
+ * already aligned on it before the reference was computed. The copies are
+ * exact, so no pixel may differ.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] check Check state with the reference computed
+ */
+static void	check_mirror(t_check *check)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+
+	symmetry_render(&check->data, check->area, thread_data);
+	check_compare(check, "mirror", 0);
+}
+
+/**
+ * @brief Checks every path on one view
+ *
+ * @details Views across an axis of symmetry are aligned on it first, as
+ * the renderer does, and also check the mirrored path.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] check Check state with the fractal type and view name
+ * @param[in] center Complex point at the centre of the view
+ * @param[in] zoom Zoom factor, the default view being 1
+ */
+static void	check_view(t_check *check, t_complex center, double zoom)
+{
+	int	mirrored;
+
+	check->data.zoom_factor = zoom;
+	check->data.min = center;
+	check->data.max = (t_complex){center.real + 1.5 / zoom,
+		center.imag + 1.5 / zoom};
+	mirrored = symmetry_align(&check->data, check->area);
+	check->data.tier = TIER_EXACT;
+	check_render(check, 1);
+	check_render(check, 0);
+	check_compare(check, "exact", 0);
+	if (mirrored)
+		check_mirror(check);
+	check->data.tier = TIER_PREVIEW;
+	check_render(check, 0);
+	check_compare(check, "preview", check_tolerance(check->data.type));
+	check->data.tier = TIER_EXACT;
+	check_vm(check);
+}
+
+/**
+ * @brief Picks a random view near the edge of the set
+ *
+ * @details Among a few random centres, keeps the one that escapes last, so
+ * deep random views still show structure rather than a flat colour.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] check Check state with the generator
+ * @param[out] center Centre of the view
+ *
+ * @return double Zoom factor of the view
+ */
+static double	check_random_view(t_check *check, t_complex *center)
+{
+	t_complex	point;
+	int			best;
+	int			dives;
+	int			i;
+
+	check->data.zoom_factor = 1.0;
+	best = -1;
+	i = -1;
+	while (++i < 64)
+	{
+		point.real = check_unit(&check->rng) * 4 - 2;
+		point.imag = check_unit(&check->rng) * 4 - 2;
+		dives = check_diverge(&check->data, point);
+		if (dives > 0 && (best < 0 || dives < best))
+		{
+			best = dives;
+			*center = point;
+		}
+	}
+	if (best < 0)
+		*center = point;
+	return (pow(2, check_unit(&check->rng) * CHECK_DEPTH));
+}
+
+/**
+ * @brief Checks every path of one formula on the fixed and random views
+ *
+ * @details Every formula sees the same random views for a given seed.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] check Check state
+ * @param[in] type Fractal type
+ * @param[in] views Number of random views
+ * @param[in] seed Seed of the random views
+ */
+static void	check_formula(t_check *check, t_fractals type, int views,
+				Uint64 seed)
+{
+	static const double	fixed[][3] = {{-1, -0.5, 1}, {-0.7453, 0.1127, 100},
+	{-0.1011, 0.9563, 2000}, {-0.0137, 0.0211, 4}};
+	t_complex			center;
+	double				zoom;
+	int					i;
+
+	check->data.type = type;
+	check->data.initial_z = fractal_formula(type)->start;
+	check->data.initial_c = (t_complex){-0.8, 0.156};
+	i = -1;
+	while (++i < (int)(sizeof(fixed) / sizeof(fixed[0])))
+	{
+		snprintf(check->view, sizeof(check->view), "fixed%d", i + 1);
+		check_view(check, (t_complex){fixed[i][0], fixed[i][1]}, fixed[i][2]);
+	}
+	check->rng = seed;
+	i = -1;
+	while (++i < views)
+	{
+		zoom = check_random_view(check, &center);
+		snprintf(check->view, sizeof(check->view), "random%d", i + 1);
+		check_view(check, center, zoom);
+	}
+}
+
+/**
+ * @brief Runs one batch complex operation over the operand arrays
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] ops Batch operations under test
+ * @param[in] op Index of the operation, in t_complex_ops order
+ * @param[in,out] v Operands followed by the result arrays
+ */
+static void	check_op_run(const t_complex_ops *ops, int op, double *v)
+{
+	t_complex_soa	a;
+	t_complex_soa	b;
+	t_complex_soa	dst;
+
+	a = (t_complex_soa){v, v + CHECK_OPS_LEN};
+	b = (t_complex_soa){v + 2 * CHECK_OPS_LEN, v + 3 * CHECK_OPS_LEN};
+	dst = (t_complex_soa){v + 4 * CHECK_OPS_LEN, v + 5 * CHECK_OPS_LEN};
+	memset(dst.real, 0, 2 * CHECK_OPS_LEN * sizeof(double));
+	if (op == 0)
+		ops->add(dst, a, b, CHECK_OPS_LEN);
+	else if (op == 1)
+		ops->sub(dst, a, b, CHECK_OPS_LEN);
+	else if (op == 2)
+		ops->mul(dst, a, b, CHECK_OPS_LEN);
+	else if (op == 3)
+		ops->div(dst, a, b, CHECK_OPS_LEN);
+	else if (op == 4)
+		ops->inv(dst, a, CHECK_OPS_LEN);
+	else if (op == 5)
+		ops->sinh(dst, a, CHECK_OPS_LEN);
+	else
+		ops->norm(dst.real, a, CHECK_OPS_LEN);
+}
+
+/**
+ * @brief Compares the vector batch operations with the scalar ones
+ *
+ * @details Operands span many orders of magnitude. Results must match bit
+ * for bit, since the vector versions keep the scalar operation order.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] check Check state with the generator
+ * @param[in] v 8 x CHECK_OPS_LEN doubles of scratch space
+ */
+static void	check_ops(t_check *check, double *v)
+{
+	static const char	*names[7] = {"add", "sub", "mul", "div", "inv",
+		"sinh", "norm"};
+	char				line[96];
+	int					differ;
+	int					op;
+	int					i;
+
+	if (!complex_ops_avx2())
+	{
+		print_format("\033[0;93mNo AVX2 operations on this CPU, batch "
+			"operations not compared\n\033[0;39m");
+		return ;
+	}
+	i = -1;
+	while (++i < 4 * CHECK_OPS_LEN)
+		v[i] = (check_unit(&check->rng) * 2 - 1)
+			* pow(2, check_unit(&check->rng) * 40 - 20);
+	op = -1;
+	while (++op < 7)
+	{
+		check_op_run(complex_ops_scalar(), op, v);
+		mem_copy(v + 6 * CHECK_OPS_LEN, v + 4 * CHECK_OPS_LEN,
+			2 * CHECK_OPS_LEN * sizeof(double));
+		check_op_run(complex_ops_avx2(), op, v);
+		differ = 0;
+		i = -1;
+		while (++i < 2 * CHECK_OPS_LEN)
+			differ += memcmp(v + 4 * CHECK_OPS_LEN + i,
+					v + 6 * CHECK_OPS_LEN + i, sizeof(double)) != 0;
+		snprintf(line, sizeof(line), "%-10s %-8s %-8s %6d / %d differ",
+			"avx2", "ops", names[op], differ, 2 * CHECK_OPS_LEN);
+		check->compared++;
+		check->failed += differ > 0;
+		if (differ)
+			print_format("\033[0;91m%s  FAIL\n\033[0;39m", line);
+		else
+			print_format("\033[0;92m%s  ok\n\033[0;39m", line);
+	}
+}
+
+/**
+ * @brief Runs the differential check of the optimized render paths
+ *
+ * @details Entry point of "./fractol check [views] [seed]". The views and
+ * seed default to CHECK_VIEWS and 1. Difference images are written to the
+ * working directory as check_<formula>_<view>_<path>.bmp.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] cpu Worker thread count and placement
+ * @param[in] argc Number of command-line arguments
+ * @param[in] argv Command-line arguments, argv[1] being "check"
+ *
+ * @return int Exit status
+ * @retval 0 Every path within its tolerance
+ * @retval 1 A path beyond its tolerance, or allocation failure
+ */
+int	render_check(const t_cpu *cpu, int argc, char **argv)
+{
+	t_check	*check;
+	double	*scratch;
+	Uint64	seed;
+	int		views;
+	int		status;
+	int		type;
+
+	views = CHECK_VIEWS;
+	if (argc >= 3)
+		views = str_to_int(argv[2]);
+	check = (t_check *)calloc(1, sizeof(t_check));
+	scratch = (double *)malloc(8 * CHECK_OPS_LEN * sizeof(double));
+	if (check)
+	{
+		check->data.cpu = *cpu;
+		check->area = (SDL_Rect){(SCREEN_WIDTH - CHECK_SIZE) / 2,
+			(SCREEN_HEIGHT - CHECK_SIZE) / 2, CHECK_SIZE, CHECK_SIZE};
+		check->data.iters = (int *)malloc(SCREEN_WIDTH * SCREEN_HEIGHT
+				* sizeof(int));
+		check->oracle = (int *)malloc(CHECK_SIZE * CHECK_SIZE * sizeof(int));
+		check->image = (Uint8 *)malloc(BMP_HEADER_SIZE + CHECK_SIZE
+				* CHECK_SIZE * 4);
+	}
+	status = !check || !scratch || !check->data.iters || !check->oracle
+		|| !check->image;
+	if (!status)
+	{
+		seed = 0x9E3779B97F4A7C15ULL;
+		if (argc >= 4)
+			seed ^= (Uint64)str_to_int(argv[3]);
+		check->rng = seed;
+		check_ops(check, scratch);
+		type = -1;
+		while (++type < FRACTAL_COUNT)
+			if (!fractal_formula(type)->user)
+				check_formula(check, type, views, seed);
+		status = check->failed > 0;
+		if (status)
+			print_format("\033[0;91m%d of %d comparisons failed\n\033[0;39m",
+				check->failed, check->compared);
+		else
+			print_format("\033[0;92mAll %d comparisons passed\n\033[0;39m",
+				check->compared);
+	}
+	else
+		print_format("\033[0;91mRender check allocation failed\n\033[0;39m");
+	if (check)
+	{
+		free(check->data.iters);
+		free(check->oracle);
+		free(check->image);
+	}
+	free(check);
+	free(scratch);
+	return (status);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file cycle.c
+ * @brief Continuous colour cycling of the stored escape counts
+ *
+ * @details While cycling is on, the idle event loop advances the colour
+ * phase every CYCLE_FRAME_MS by the time elapsed, rebuilds the palette and
+ * recolours the escape counts kept from the last render into a new frame.
+ * Those are the 1x counts, so supersampled pixels are not anti-aliased
+ * while cycling. The fractal kernels never run: a frame costs one palette of a few hundred
+ * entries and one table lookup per pixel, spread over the worker threads.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Puts the colour cycling state in its disabled state
+ *
+ * @ingroup fractal_render
+ *
+ * @param[out] cycle Colour cycling state
+ */
+void	cycle_init(t_cycle *cycle)
+{
+	cycle->enabled = 0;
+	cycle->phase = 0.0;
+	cycle->last = 0;
+	cycle->frames = 0;
+	cycle->ms = 0.0;
+}
+
+/**
+ * @brief Enables or disables colour cycling
+ *
+ * @details Orbit density images do not keep escape counts, so they cannot
+ * be cycled; cycling enabled before them resumes once they are left.
+ * Cycled frames recolour the 1x escape counts, so with supersampling on
+ * they show the view without its anti-aliasing; disabling then marks the
+ * view for redrawing to bring the refined pixels back. Disabling prints the
+ * frames cycled and the mean time of their colour passes; the colours
+ * reached are kept.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the cycling state
+ */
+void	cycle_toggle(t_data *data)
+{
+	t_cycle	*cycle;
+	char	text[32];
+
+	cycle = &data->cycle;
+	if (!cycle->enabled && data->density.enabled)
+	{
+		print_format("\033[0;91mColour cycling needs escape-time colouring\n"
+			"\033[0;39m");
+		return ;
+	}
+	cycle->enabled = !cycle->enabled;
+	if (cycle->enabled)
+	{
+		cycle->last = session_ticks(data);
+		cycle->frames = 0;
+		cycle->ms = 0.0;
+		print_format("\033[0;92mColour cycling enabled\n\033[0;39m");
+		return ;
+	}
+	snprintf(text, sizeof(text), "%.3f", cycle->ms / fmax(cycle->frames, 1));
+	print_format("\033[0;93mColour cycling disabled (%d frames, %s ms per "
+		"colour pass)\n\033[0;39m", cycle->frames, text);
+	if (data->supersample)
+		data->needs_redraw = 1;
+}
+
+/**
+ * @brief Time left before the next frame of colour cycling
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the cycling state
+ *
+ * @return int Milliseconds to wait, 0 if due now, -1 if not cycling
+ */
+int	cycle_due(t_data *data)
+{
+	Uint32	since;
+
+	if (!data->cycle.enabled || data->density.enabled)
+		return (-1);
+	since = session_ticks(data) - data->cycle.last;
+	if (since >= CYCLE_FRAME_MS)
+		return (0);
+	return (CYCLE_FRAME_MS - since);
+}
+
+/**
+ * @brief Recolours the view with the next colour phase
+ *
+ * @details Called from the event loop while nothing else is pending. The
+ * phase advances by CYCLE_RATE times the time since the last frame, so the
+ * speed of the animation does not depend on the frame rate; the psychedelic
+ * scheme takes it through color_off and the HSV scheme as a hue rotation.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the cycling state
+ *
+ * @return int Whether a frame was cycled
+ * @retval 1 The view was recoloured
+ * @retval 0 No frame due yet
+ */
+int	cycle_step(t_data *data)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+	Uint64			start;
+	Uint32			now;
+	double			step;
+
+	if (cycle_due(data))
+		return (0);
+	now = session_ticks(data);
+	step = (now - data->cycle.last) * CYCLE_RATE / 1000.0;
+	data->cycle.last = now;
+	data->color_off = fmod(data->color_off + step, 2 * PI);
+	data->cycle.phase = fmod(data->cycle.phase + step, 2 * PI);
+	start = SDL_GetPerformanceCounter();
+	if (build_palette(data) || frame_begin(data))
+		return (1);
+	run_threaded(data, data->frame, recolor_threaded, thread_data);
+	frame_end(data);
+	data->cycle.ms += (double)(SDL_GetPerformanceCounter() - start) * 1000.0
+		/ SDL_GetPerformanceFrequency();
+	data->cycle.frames++;
+	return (1);
+}
@@ -0,0 +1,528 @@
+/**
+ * @file density.c
+ * @brief Progressive orbit density images (Buddhabrot and its Julia form)
+ *
+ * @details Instead of colouring each pixel by its own escape count, random
+ * starting points are iterated with the orbit kernel of the formula and
+ * every point visited by an escaping orbit is counted on the pixel it falls
+ * on. Samples keep accumulating while the view is idle, one short pass at a
+ * time, and the partial image is shown after every pass. Workers fill
+ * private histograms that are summed strip by strip once the pass is over,
+ * so the sampling loop shares no memory and needs no atomics.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Puts the orbit density state in its disabled state
+ *
+ * @ingroup fractal_render
+ *
+ * @param[out] density Orbit density state
+ */
+void	density_init(t_density *density)
+{
+	density->enabled = 0;
+	density->workers = NULL;
+	density->count = 0;
+	density->hist = NULL;
+	density->per_thread = 1024;
+}
+
+/**
+ * @brief Draws a uniform random number in [0, 1)
+ *
+ * @details xorshift64* generator. Each worker owns one, so random numbers
+ * are drawn without locking and every worker gets its own stream.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] state Generator state, never zero
+ *
+ * @return double Random number
+ */
+static double	next_unit(Uint64 *state)
+{
+	Uint64	x;
+
+	x = *state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+	return ((double)((x * 0x2545F4914F6CDD1DULL) >> 11)
+		* (1.0 / 9007199254740992.0));
+}
+
+/**
+ * @brief Picks an importance map cell from a uniform random number
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] density Orbit density state with the cumulative probabilities
+ * @param[in] u Uniform random number in [0, 1)
+ *
+ * @return int First cell whose cumulative probability exceeds u
+ */
+static int	pick_cell(const t_density *density, double u)
+{
+	int	low;
+	int	high;
+	int	mid;
+
+	low = 0;
+	high = DENSITY_CELLS - 1;
+	while (low < high)
+	{
+		mid = (low + high) / 2;
+		if (density->cdf[mid] > u)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	return (low);
+}
+
+/**
+ * @brief Rebuilds the importance map from the cell statistics
+ *
+ * @details A cell is worth its share of samples whose orbit reached the
+ * view, with one useful and one wasted sample assumed up front so unseen
+ * cells start even. DENSITY_EXPLORE of the probability is spread uniformly.
+ * The weight of a sample is the uniform probability of its cell divided by
+ * the probability it was drawn with, which keeps the image unbiased.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] density Orbit density state
+ */
+static void	density_weights(t_density *density)
+{
+	double	total;
+	double	p;
+	int		i;
+
+	total = 0;
+	i = -1;
+	while (++i < DENSITY_CELLS)
+	{
+		density->weight[i] = (density->useful[i] + 1)
+			/ (density->drawn[i] + 2);
+		total += density->weight[i];
+	}
+	p = 0;
+	i = -1;
+	while (++i < DENSITY_CELLS)
+	{
+		density->cdf[i] = (1 - DENSITY_EXPLORE) * density->weight[i] / total
+			+ DENSITY_EXPLORE / DENSITY_CELLS;
+		density->weight[i] = 1.0 / (DENSITY_CELLS * density->cdf[i]);
+		p += density->cdf[i];
+		density->cdf[i] = p;
+	}
+	density->cdf[DENSITY_CELLS - 1] = 1.0;
+}
+
+/**
+ * @brief Counts the visible points of an orbit in a private histogram
+ *
+ * @details view holds the inverse of screen_to_complex(): the complex point
+ * of the left edge of column 0 and top of row 0, then the pixels per unit
+ * along each axis. Written so that NaN points fail the bounds test.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] view Plane origin and scale of the screen
+ * @param[in,out] hist Private histogram of the worker
+ * @param[in] orbit Points visited by the orbit
+ * @param[in] n Number of points
+ * @param[in] weight Weight of the sample
+ *
+ * @return int Number of points that fell on the screen
+ */
+static int	plot_orbit(const double *view, float *hist, const t_complex *orbit,
+				int n, float weight)
+{
+	double	x;
+	double	y;
+	int		hits;
+	int		i;
+
+	hits = 0;
+	i = -1;
+	while (++i < n)
+	{
+		x = (orbit[i].real - view[0]) * view[2];
+		y = (orbit[i].imag - view[1]) * view[3];
+		if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT)
+		{
+			hist[(int)y * SCREEN_WIDTH + (int)x] += weight;
+			hits++;
+		}
+	}
+	return (hits);
+}
+
+/**
+ * @brief Worker routine tracing a pass worth of random orbits
+ *
+ * @details Draws a cell from the importance map and a uniform point inside
+ * it, traces its orbit and, if it escapes, adds the weighted points to the
+ * private histogram. The strip of the thread data is not used: every
+ * worker samples the whole plane. The orbit buffer is carved from the
+ * scratch arena of the round, so passes do not allocate.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] arg Pointer to the t_thread_data of this worker
+ *
+ * @return void* Always NULL
+ */
+static void	*density_sample_threaded(void *arg)
+{
+	t_thread_data		*thread_data;
+	t_density			*density;
+	t_density_worker	*worker;
+	const t_formula		*formula;
+	t_complex			*orbit;
+	t_complex			point;
+	double				view[4];
+	int					cell;
+	int					i;
+
+	thread_data = (t_thread_data *)arg;
+	density = &thread_data->data->density;
+	worker = &density->workers[thread_data->thread_id];
+	formula = fractal_formula(thread_data->data->type);
+	orbit = (t_complex *)arena_alloc(&thread_data->data->scratch,
+			iteration_cap(thread_data->data) * sizeof(t_complex));
+	if (!orbit)
+		return (NULL);
+	point = screen_to_complex(thread_data->data, 0, 0);
+	view[0] = point.real;
+	view[1] = point.imag;
+	point = screen_to_complex(thread_data->data, SCREEN_WIDTH, SCREEN_HEIGHT);
+	view[2] = SCREEN_WIDTH / (point.real - view[0]);
+	view[3] = SCREEN_HEIGHT / (point.imag - view[1]);
+	i = -1;
+	while (++i < density->per_thread)
+	{
+		cell = pick_cell(density, next_unit(&worker->rng));
+		point.real = (cell % DENSITY_GRID + next_unit(&worker->rng))
+			* (2 * DENSITY_RADIUS / DENSITY_GRID) - DENSITY_RADIUS;
+		point.imag = (cell / DENSITY_GRID + next_unit(&worker->rng))
+			* (2 * DENSITY_RADIUS / DENSITY_GRID) - DENSITY_RADIUS;
+		worker->drawn[cell]++;
+		if (plot_orbit(view, worker->hist, orbit, formula->orbit(
+					thread_data->data, point, orbit), density->weight[cell]))
+			worker->useful[cell]++;
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Worker routine adding the private histograms into the image
+ *
+ * @details Each worker sums the rows of its strip over every private
+ * histogram and clears them for the next pass, so no two workers touch the
+ * same memory. The highest value of the strip is left in the worker state.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] arg Pointer to the t_thread_data of this worker
+ *
+ * @return void* Always NULL
+ */
+static void	*density_merge_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+	t_density		*density;
+	float			*hist;
+	float			peak;
+	int				w;
+	int				i;
+
+	thread_data = (t_thread_data *)arg;
+	density = &thread_data->data->density;
+	w = -1;
+	while (++w < density->count)
+	{
+		hist = density->workers[w].hist;
+		i = thread_data->start_y * SCREEN_WIDTH - 1;
+		while (++i < thread_data->end_y * SCREEN_WIDTH)
+		{
+			density->hist[i] += hist[i];
+			hist[i] = 0;
+		}
+	}
+	peak = 0;
+	i = thread_data->start_y * SCREEN_WIDTH - 1;
+	while (++i < thread_data->end_y * SCREEN_WIDTH)
+		peak = fmaxf(peak, density->hist[i]);
+	density->workers[thread_data->thread_id].peak = peak;
+	return (NULL);
+}
+
+/**
+ * @brief Worker routine colouring its strip from the accumulated image
+ *
+ * @details Densities are mapped on a logarithmic scale relative to the
+ * highest one, so faint orbits stay visible next to the dense ones.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] arg Pointer to the t_thread_data of this worker
+ *
+ * @return void* Always NULL
+ */
+static void	*density_shade_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+	t_density		*density;
+	t_vector2		pos;
+	double			scale;
+
+	thread_data = (t_thread_data *)arg;
+	density = &thread_data->data->density;
+	scale = 0;
+	if (density->peak > 0)
+		scale = 1000.0 / density->peak;
+	pos.y = thread_data->start_y - 1;
+	while (++pos.y < thread_data->end_y)
+	{
+		pos.x = thread_data->start_x - 1;
+		while (++pos.x < thread_data->end_x)
+			my_mlx_pixel_put(thread_data->data, pos, density_color(
+					log1p(density->hist[pos.y * SCREEN_WIDTH + pos.x] * scale)
+					/ log1p(1000.0)));
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Gathers the cell statistics of a finished pass
+ *
+ * @details Adds and clears the private cell counters, rebuilds the
+ * importance map and sizes the next pass so it lasts about DENSITY_PASS_MS.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] density Orbit density state
+ * @param[in] ms Duration of the sampling pass in milliseconds
+ */
+static void	density_collect(t_density *density, double ms)
+{
+	t_density_worker	*worker;
+	int					w;
+	int					i;
+
+	w = -1;
+	while (++w < density->count)
+	{
+		worker = &density->workers[w];
+		i = -1;
+		while (++i < DENSITY_CELLS)
+		{
+			density->drawn[i] += worker->drawn[i];
+			density->useful[i] += worker->useful[i];
+		}
+		memset(worker->drawn, 0, sizeof(worker->drawn));
+		memset(worker->useful, 0, sizeof(worker->useful));
+	}
+	density_weights(density);
+	density->samples += (double)density->per_thread * density->count;
+	density->busy_ms += ms;
+	density->per_thread *= fmin(2.0, DENSITY_PASS_MS / fmax(ms, 1.0));
+	density->per_thread = fmax(64, fmin(density->per_thread, 1 << 22));
+}
+
+/**
+ * @brief Reports the sampling rate every DENSITY_REPORT_MS
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] density Orbit density state
+ */
+static void	density_report(t_density *density)
+{
+	if (SDL_GetTicks() - density->reported < DENSITY_REPORT_MS
+		|| density->busy_ms <= 0)
+		return ;
+	density->reported = SDL_GetTicks();
+	print_format("\033[0;92mOrbit density: %d samples/s, %dk samples\n"
+		"\033[0;39m", (int)(density->samples * 1000.0 / density->busy_ms),
+		(int)(density->samples / 1000));
+}
+
+/**
+ * @brief Adds one progressive pass of orbit samples and shows the image
+ *
+ * @details Called from the event loop while the view is idle. Samples are
+ * traced in parallel into the private histograms, merged into the image in
+ * parallel, and the whole screen is recoloured from the merged image.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the density state
+ *
+ * @return int Whether a pass was run
+ * @retval 1 A pass was added and the frame updated
+ * @retval 0 Orbit density mode is disabled
+ */
+int	density_refine(t_data *data)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+	t_density		*density;
+	SDL_Rect		screen;
+	Uint64			start;
+	int				i;
+
+	density = &data->density;
+	if (!density->enabled)
+		return (0);
+	screen = (SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+	start = SDL_GetPerformanceCounter();
+	run_threaded(data, screen, density_sample_threaded, thread_data);
+	density_collect(density, (double)(SDL_GetPerformanceCounter() - start)
+		* 1000.0 / SDL_GetPerformanceFrequency());
+	run_threaded(data, screen, density_merge_threaded, thread_data);
+	density->peak = 0;
+	i = -1;
+	while (++i < data->cpu.threads)
+		density->peak = fmaxf(density->peak, density->workers[i].peak);
+	density_report(density);
+	if (frame_begin(data))
+		return (1);
+	run_threaded(data, data->frame, density_shade_threaded, thread_data);
+	frame_end(data);
+	return (1);
+}
+
+/**
+ * @brief Discards the accumulated image after the view changed
+ *
+ * @details The importance map is reset as well, since which starting
+ * points reach the screen depends on the view.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the density state
+ */
+void	density_reset(t_data *data)
+{
+	t_density	*density;
+
+	density = &data->density;
+	memset(density->hist, 0, SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(float));
+	memset(density->drawn, 0, sizeof(density->drawn));
+	memset(density->useful, 0, sizeof(density->useful));
+	density_weights(density);
+	density->peak = 0;
+	density->samples = 0;
+	density->busy_ms = 0;
+	density->reported = SDL_GetTicks();
+}
+
+/**
+ * @brief Releases the histograms and disables orbit density mode
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] density Orbit density state
+ */
+void	density_free(t_density *density)
+{
+	int	i;
+
+	i = -1;
+	while (density->workers && ++i < density->count)
+		free(density->workers[i].hist);
+	free(density->workers);
+	free(density->hist);
+	density->workers = NULL;
+	density->hist = NULL;
+	density->count = 0;
+	density->enabled = 0;
+}
+
+/**
+ * @brief Allocates the merged and private histograms
+ *
+ * @details Worker generators are seeded from their index, so runs are
+ * reproducible for a given worker count.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] density Orbit density state
+ * @param[in] count Number of worker threads
+ *
+ * @return int Status of the allocation
+ * @retval 0 Histograms ready
+ * @retval 1 Out of memory
+ */
+static int	density_alloc(t_density *density, int count)
+{
+	int	i;
+
+	density->hist = (float *)calloc(SCREEN_WIDTH * SCREEN_HEIGHT,
+			sizeof(float));
+	density->workers = (t_density_worker *)calloc(count,
+			sizeof(t_density_worker));
+	if (!density->hist || !density->workers)
+		return (1);
+	density->count = count;
+	i = -1;
+	while (++i < count)
+	{
+		density->workers[i].rng = (i + 1) * 0x9E3779B97F4A7C15ULL;
+		density->workers[i].hist = (float *)calloc(SCREEN_WIDTH
+				* SCREEN_HEIGHT, sizeof(float));
+		if (!density->workers[i].hist)
+			return (1);
+	}
+	return (0);
+}
+
+/**
+ * @brief Enables or disables orbit density mode
+ *
+ * @details Enabling allocates one private histogram per worker thread and
+ * starts accumulating from an empty image; disabling releases them and
+ * marks the escape-time view for redrawing. User formulas have no orbit
+ * kernel and stay in escape-time mode.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the density state
+ */
+void	density_toggle(t_data *data)
+{
+	t_density	*density;
+
+	density = &data->density;
+	if (density->enabled)
+	{
+		density_free(density);
+		print_format("\033[0;93mOrbit density disabled\n\033[0;39m");
+		data->needs_redraw = 1;
+		return ;
+	}
+	if (!fractal_formula(data->type)->orbit)
+	{
+		print_format("\033[0;91mOrbit density is not available for user "
+			"formulas\n\033[0;39m");
+		return ;
+	}
+	if (density_alloc(density, data->cpu.threads))
+	{
+		density_free(density);
+		print_format("\033[0;91mOrbit density allocation failed\n\033[0;39m");
+		return ;
+	}
+	density->enabled = 1;
+	print_format("\033[0;92mOrbit density enabled\n\033[0;39m");
+	density_reset(data);
+}
@@ -0,0 +1,435 @@
+/**
+ * @file formula_parse.c
+ * @brief Compiler of user formulas to register bytecode
+ *
+ * @details Recursive descent over the grammar
+ *
+ *     expr    := term (('+' | '-') term)*
+ *     term    := unary (('*' | '/') unary)*
+ *     unary   := '-' unary | power
+ *     power   := primary ('^' unary)?
+ *     primary := number | 'z' | 'c' | 'i' | 'pi' | name '(' expr ')'
+ *              | '(' expr ')'
+ *
+ * Every rule returns the register holding its value. Operations on
+ * constants are evaluated at compile time, and integer powers become
+ * multiplications, so "z^3 + sinh(c)/z" compiles to five instructions.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "formula.h"
+
+static int	parse_expr(t_parser *parser);
+static int	parse_unary(t_parser *parser);
+
+/**
+ * @brief Skips blanks and returns the next character of the source
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ *
+ * @return char Next significant character, '\0' at the end
+ */
+static char	peek(t_parser *parser)
+{
+	while (parser->text[parser->pos] == ' '
+		|| parser->text[parser->pos] == '\t')
+		parser->pos++;
+	return (parser->text[parser->pos]);
+}
+
+/**
+ * @brief Records a compile error unless one was already found
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ * @param[in] message Description of the error
+ *
+ * @return int Always -1, the invalid register
+ */
+static int	fail(t_parser *parser, const char *message)
+{
+	if (!parser->error)
+		parser->error = message;
+	return (-1);
+}
+
+/**
+ * @brief Allocates a register, constant or computed
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ * @param[in] constant Whether the register holds a compile-time constant
+ * @param[in] value Value of a constant register
+ *
+ * @return int New register, or -1 when every register is in use
+ */
+static int	new_register(t_parser *parser, int constant, t_complex value)
+{
+	t_program	*program;
+
+	program = parser->program;
+	if (program->nregs == VM_MAX_REGS)
+		return (fail(parser, "formula too long"));
+	program->constant[program->nregs] = constant;
+	program->value[program->nregs] = value;
+	return (program->nregs++);
+}
+
+/**
+ * @brief Emits an instruction, or folds it when its operands are constant
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ * @param[in] op Instruction opcode
+ * @param[in] a First operand register
+ * @param[in] b Second operand register (same as a for unary operations)
+ *
+ * @return int Register holding the result, or -1 on error
+ */
+static int	emit(t_parser *parser, int op, int a, int b)
+{
+	t_program	*program;
+	int			dst;
+
+	program = parser->program;
+	if (a < 0 || b < 0)
+		return (-1);
+	if (program->constant[a] && program->constant[b])
+		return (new_register(parser, 1,
+				vm_apply(op, program->value[a], program->value[b])));
+	if (program->len == VM_MAX_CODE)
+		return (fail(parser, "formula too long"));
+	dst = new_register(parser, 0, (t_complex){0, 0});
+	if (dst < 0)
+		return (-1);
+	program->code[program->len++] = (t_vm_op){op, dst, a, b};
+	return (dst);
+}
+
+/**
+ * @brief Emits base raised to a constant integer exponent
+ *
+ * @details Square-and-multiply from the most significant bit, so z^2 is
+ * z * z and z^3 is (z * z) * z, exactly like the built-in kernels. Negative
+ * exponents take the reciprocal of the positive power.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ * @param[in] base Register of the base
+ * @param[in] exponent Integer exponent, at most 64 in magnitude
+ *
+ * @return int Register holding the power, or -1 on error
+ */
+static int	integer_power(t_parser *parser, int base, int exponent)
+{
+	int	result;
+	int	bit;
+
+	if (exponent == 0)
+		return (new_register(parser, 1, (t_complex){1, 0}));
+	bit = 64;
+	while (!(abs(exponent) & bit))
+		bit >>= 1;
+	result = base;
+	while (bit > 1)
+	{
+		bit >>= 1;
+		result = emit(parser, VM_MUL, result, result);
+		if (abs(exponent) & bit)
+			result = emit(parser, VM_MUL, result, base);
+	}
+	if (exponent < 0)
+		result = emit(parser, VM_INV, result, result);
+	return (result);
+}
+
+/**
+ * @brief Compiles a function call, its name already read
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ * @param[in] name Function name
+ * @param[in] len Length of the name
+ *
+ * @return int Register holding the result, or -1 on error
+ */
+static int	parse_call(t_parser *parser, const char *name, int len)
+{
+	static const char	*names[] = {"exp", "log", "sqrt", "sin", "cos",
+		"sinh", "cosh", "conj", "abs", NULL};
+	static const int	ops[] = {VM_EXP, VM_LOG, VM_SQRT, VM_SIN, VM_COS,
+		VM_SINH, VM_COSH, VM_CONJ, VM_ABS};
+	int					arg;
+	int					i;
+
+	i = 0;
+	while (names[i] && !((int)str_len(names[i]) == len
+			&& str_compare_n(name, names[i], len)))
+		i++;
+	if (!names[i])
+	{
+		parser->pos = name - parser->text;
+		return (fail(parser, "unknown name"));
+	}
+	if (peek(parser) != '(')
+		return (fail(parser, "expected '(' after function name"));
+	parser->pos++;
+	arg = parse_expr(parser);
+	if (peek(parser) != ')')
+		return (fail(parser, "expected ')'"));
+	parser->pos++;
+	return (emit(parser, ops[i], arg, arg));
+}
+
+/**
+ * @brief Compiles a number, variable, constant, call or parenthesis
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ *
+ * @return int Register holding the value, or -1 on error
+ */
+static int	parse_primary(t_parser *parser)
+{
+	const char	*start;
+	char		*end;
+	int			reg;
+
+	if (is_digit(peek(parser)) || peek(parser) == '.')
+	{
+		start = parser->text + parser->pos;
+		reg = new_register(parser, 1, (t_complex){strtod(start, &end), 0});
+		parser->pos += end - start;
+		return (reg);
+	}
+	if (peek(parser) == '(')
+	{
+		parser->pos++;
+		reg = parse_expr(parser);
+		if (peek(parser) != ')')
+			return (fail(parser, "expected ')'"));
+		parser->pos++;
+		return (reg);
+	}
+	start = parser->text + parser->pos;
+	while (is_alphabetic(parser->text[parser->pos]))
+		parser->pos++;
+	if (parser->text + parser->pos - start == 1 && (*start == 'z'
+			|| *start == 'c'))
+		return (*start == 'c');
+	if (parser->text + parser->pos - start == 1 && *start == 'i')
+		return (new_register(parser, 1, (t_complex){0, 1}));
+	if (parser->text + parser->pos - start == 2
+		&& str_compare_n(start, "pi", 2))
+		return (new_register(parser, 1, (t_complex){PI, 0}));
+	if (parser->text + parser->pos == start)
+		return (fail(parser, "expected a value"));
+	return (parse_call(parser, start, parser->text + parser->pos - start));
+}
+
+/**
+ * @brief Compiles a primary raised to an optional power
+ *
+ * @details Real integer exponents of at most 64 known at compile time
+ * become multiplications; the range is checked before the exponent is
+ * converted to an int. Any other exponent uses exp(b log(a)).
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ *
+ * @return int Register holding the value, or -1 on error
+ */
+static int	parse_power(t_parser *parser)
+{
+	t_program	*program;
+	t_complex	value;
+	int			base;
+	int			exponent;
+
+	program = parser->program;
+	base = parse_primary(parser);
+	if (base < 0 || peek(parser) != '^')
+		return (base);
+	parser->pos++;
+	exponent = parse_unary(parser);
+	if (exponent < 0)
+		return (-1);
+	value = program->value[exponent];
+	if (program->constant[exponent] && value.imag == 0
+		&& fabs(value.real) <= 64 && value.real == (int)value.real)
+		return (integer_power(parser, base, (int)value.real));
+	return (emit(parser, VM_POW, base, exponent));
+}
+
+/**
+ * @brief Compiles an optionally negated power
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ *
+ * @return int Register holding the value, or -1 on error
+ */
+static int	parse_unary(t_parser *parser)
+{
+	int	value;
+
+	if (peek(parser) != '-')
+		return (parse_power(parser));
+	parser->pos++;
+	value = parse_unary(parser);
+	return (emit(parser, VM_NEG, value, value));
+}
+
+/**
+ * @brief Compiles a product or quotient of unary terms
+ *
+ * @details A quotient with a numerator of exactly 1 compiles to an
+ * inversion, like the built-in 1/c terms.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ *
+ * @return int Register holding the value, or -1 on error
+ */
+static int	parse_term(t_parser *parser)
+{
+	t_program	*program;
+	int			left;
+	int			right;
+	char		op;
+
+	program = parser->program;
+	left = parse_unary(parser);
+	while (left >= 0 && (peek(parser) == '*' || peek(parser) == '/'))
+	{
+		op = parser->text[parser->pos++];
+		right = parse_unary(parser);
+		if (op == '*')
+			left = emit(parser, VM_MUL, left, right);
+		else if (program->constant[left] && program->value[left].real == 1
+			&& program->value[left].imag == 0)
+			left = emit(parser, VM_INV, right, right);
+		else
+			left = emit(parser, VM_DIV, left, right);
+	}
+	return (left);
+}
+
+/**
+ * @brief Compiles a sum or difference of terms
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] parser Compiler state
+ *
+ * @return int Register holding the value, or -1 on error
+ */
+static int	parse_expr(t_parser *parser)
+{
+	int		left;
+	int		right;
+	char	op;
+
+	left = parse_term(parser);
+	while (left >= 0 && (peek(parser) == '+' || peek(parser) == '-'))
+	{
+		op = parser->text[parser->pos++];
+		right = parse_term(parser);
+		if (op == '+')
+			left = emit(parser, VM_ADD, left, right);
+		else
+			left = emit(parser, VM_SUB, left, right);
+	}
+	return (left);
+}
+
+/**
+ * @brief Moves the instructions depending on c alone to the front
+ *
+ * @details A stable partition: every instruction still follows the ones it
+ * reads, since an instruction that does not depend on z only reads registers
+ * that do not either. The c-only prefix is then run once per pixel.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] program Compiled program, receiving its setup length
+ */
+static void	hoist_invariants(t_program *program)
+{
+	t_vm_op	code[VM_MAX_CODE];
+	Uint8	varying[VM_MAX_REGS];
+	int		len;
+	int		i;
+
+	memset(varying, 0, sizeof(varying));
+	varying[0] = 1;
+	i = -1;
+	while (++i < program->len)
+		varying[program->code[i].dst] = varying[program->code[i].a]
+			|| varying[program->code[i].b];
+	len = 0;
+	i = -1;
+	while (++i < program->len)
+		if (!varying[program->code[i].dst])
+			code[len++] = program->code[i];
+	program->setup = len;
+	i = -1;
+	while (++i < program->len)
+		if (varying[program->code[i].dst])
+			code[len++] = program->code[i];
+	mem_copy(program->code, code, len * sizeof(t_vm_op));
+}
+
+/**
+ * @brief Compiles a user formula to register bytecode
+ *
+ * @details The formula is an expression of z and c using + - * / ^, the
+ * functions exp, log, sqrt, sin, cos, sinh, cosh, conj and abs, and the
+ * constants i and pi. Errors are reported with their column.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[out] program Compiled program
+ * @param[in] text Formula source
+ *
+ * @return int Status of the compilation
+ * @retval 0 Program ready
+ * @retval 1 Syntax error (message printed)
+ */
+int	vm_compile(t_program *program, const char *text)
+{
+	t_parser	parser;
+	int			i;
+
+	memset(program, 0, sizeof(t_program));
+	program->nregs = 2;
+	parser = (t_parser){text, 0, program, NULL};
+	program->result = parse_expr(&parser);
+	if (!parser.error && peek(&parser))
+		fail(&parser, "unexpected character");
+	if (parser.error)
+	{
+		print_format("\033[0;91mFormula error at column %d of \"%s\": %s\n"
+			"\033[0;39m", parser.pos + 1, text, parser.error);
+		return (1);
+	}
+	hoist_invariants(program);
+	program->hash = 2166136261u;
+	i = -1;
+	while (text[++i])
+		program->hash = (program->hash ^ (Uint8)text[i]) * 16777619u;
+	return (0);
+}
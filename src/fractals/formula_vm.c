@@ -0,0 +1,371 @@
+/**
+ * @file formula_vm.c
+ * @brief Lane-parallel virtual machine running compiled user formulas
+ *
+ * @details A batch is iterated VM_LANES pixels at a time. Every instruction
+ * is one loop over the lanes of a structure-of-arrays register file, so the
+ * dispatch cost is paid once per lane group and the arithmetic loops are
+ * vectorized by the compiler. Escaped lanes are replaced by the last active
+ * one, and the group is refilled with pending pixels once it is half empty,
+ * so the lanes stay busy however unevenly the pixels escape.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "formula.h"
+
+/**
+ * @brief Evaluates one instruction on scalar operands
+ *
+ * @details Used for constant folding at compile time and for the
+ * transcendental instructions, which run lane by lane. The arithmetic
+ * matches the inline cx_ helpers of the built-in kernels.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] op Instruction opcode
+ * @param[in] a First operand
+ * @param[in] b Second operand (ignored by unary instructions)
+ *
+ * @return t_complex Result of the instruction
+ */
+t_complex	vm_apply(int op, t_complex a, t_complex b)
+{
+	double	mod;
+
+	if (op == VM_ADD)
+		return (cx_add(a, b));
+	if (op == VM_SUB)
+		return ((t_complex){a.real - b.real, a.imag - b.imag});
+	if (op == VM_MUL)
+		return (cx_mul(a, b));
+	if (op == VM_DIV)
+		return (cx_div(a, b));
+	if (op == VM_POW && a.real == 0 && a.imag == 0)
+		return ((t_complex){0, 0});
+	if (op == VM_POW)
+		return (vm_apply(VM_EXP, cx_mul(b, vm_apply(VM_LOG, a, a)), a));
+	if (op == VM_NEG)
+		return ((t_complex){-a.real, -a.imag});
+	if (op == VM_INV)
+		return (cx_inv(a));
+	if (op == VM_CONJ)
+		return ((t_complex){a.real, -a.imag});
+	mod = sqrt(cx_norm(a));
+	if (op == VM_ABS)
+		return ((t_complex){mod, 0});
+	if (op == VM_EXP)
+		return ((t_complex){exp(a.real) * cos(a.imag),
+			exp(a.real) * sin(a.imag)});
+	if (op == VM_LOG)
+		return ((t_complex){log(mod), atan2(a.imag, a.real)});
+	if (op == VM_SQRT)
+		return ((t_complex){sqrt((mod + a.real) / 2),
+			copysign(sqrt((mod - a.real) / 2), a.imag)});
+	if (op == VM_SIN)
+		return ((t_complex){sin(a.real) * cosh(a.imag),
+			cos(a.real) * sinh(a.imag)});
+	if (op == VM_COS)
+		return ((t_complex){cos(a.real) * cosh(a.imag),
+			-sin(a.real) * sinh(a.imag)});
+	if (op == VM_SINH)
+		return (cx_sinh(a));
+	return ((t_complex){cosh(a.real) * cos(a.imag),
+		sinh(a.real) * sin(a.imag)});
+}
+
+/**
+ * @brief Runs one arithmetic instruction over the lanes
+ *
+ * @details Instructions with a batch complex operation run through it, on
+ * the register arrays as they are.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] ops Batch complex operations of the CPU
+ * @param[in] op Instruction
+ * @param[in,out] regs Register file
+ * @param[in] lanes Number of active lanes
+ *
+ * @return int 1 if the instruction was run, 0 if it has no batch operation
+ */
+static int	vm_arith(const t_complex_ops *ops, t_vm_op op, t_vm_regs *regs,
+				int lanes)
+{
+	t_complex_soa	dst;
+	t_complex_soa	a;
+	t_complex_soa	b;
+
+	dst = (t_complex_soa){regs->re[op.dst], regs->im[op.dst]};
+	a = (t_complex_soa){regs->re[op.a], regs->im[op.a]};
+	b = (t_complex_soa){regs->re[op.b], regs->im[op.b]};
+	if (op.op == VM_ADD)
+		ops->add(dst, a, b, lanes);
+	else if (op.op == VM_SUB)
+		ops->sub(dst, a, b, lanes);
+	else if (op.op == VM_MUL)
+		ops->mul(dst, a, b, lanes);
+	else if (op.op == VM_DIV)
+		ops->div(dst, a, b, lanes);
+	else if (op.op == VM_INV)
+		ops->inv(dst, a, lanes);
+	else if (op.op == VM_SINH)
+		ops->sinh(dst, a, lanes);
+	else
+		return (0);
+	return (1);
+}
+
+/**
+ * @brief Runs a sequence of instructions over the lanes
+ *
+ * @details Arithmetic goes through the batch complex operations chosen for
+ * the CPU; the other instructions go through vm_apply() lane by lane.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] code Instructions to run
+ * @param[in] len Number of instructions
+ * @param[in,out] regs Register file
+ * @param[in] lanes Number of active lanes
+ */
+static void	vm_run(const t_vm_op *code, int len, t_vm_regs *regs, int lanes)
+{
+	const t_complex_ops	*ops;
+	t_complex			result;
+	int					i;
+	int					l;
+
+	ops = complex_ops();
+	i = -1;
+	while (++i < len)
+	{
+		if (vm_arith(ops, code[i], regs, lanes))
+			continue ;
+		l = -1;
+		while (++l < lanes)
+		{
+			result = vm_apply(code[i].op,
+					(t_complex){regs->re[code[i].a][l], regs->im[code[i].a][l]},
+					(t_complex){regs->re[code[i].b][l], regs->im[code[i].b][l]});
+			regs->re[code[i].dst][l] = result.real;
+			regs->im[code[i].dst][l] = result.imag;
+		}
+	}
+}
+
+/**
+ * @brief Broadcasts the constant registers of a program to every lane
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] program Compiled program
+ * @param[out] regs Register file
+ */
+static void	vm_load_constants(const t_program *program, t_vm_regs *regs)
+{
+	int	r;
+	int	l;
+
+	r = -1;
+	while (++r < program->nregs)
+	{
+		if (!program->constant[r])
+			continue ;
+		l = -1;
+		while (++l < VM_LANES)
+		{
+			regs->re[r][l] = program->value[r].real;
+			regs->im[r][l] = program->value[r].imag;
+		}
+	}
+}
+
+/**
+ * @brief Computes the initial z of every pixel of a batch
+ *
+ * @details Runs the start program with z = initial_z and c = the pixel, one
+ * lane group at a time.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the start program
+ * @param[in] batch Batch of points
+ * @param[out] z0 Initial z of each lane of the batch
+ */
+static void	vm_start(t_data *data, t_pixel_batch *batch, t_complex *z0)
+{
+	t_vm_regs	regs;
+	int			first;
+	int			n;
+	int			l;
+
+	vm_load_constants(&data->start, &regs);
+	first = 0;
+	while (first < batch->count)
+	{
+		n = fmin(VM_LANES, batch->count - first);
+		l = -1;
+		while (++l < n)
+		{
+			regs.re[0][l] = data->initial_z.real;
+			regs.im[0][l] = data->initial_z.imag;
+			regs.re[1][l] = batch->real[first + l];
+			regs.im[1][l] = batch->imag[first + l];
+		}
+		vm_run(data->start.code, data->start.len, &regs, n);
+		l = -1;
+		while (++l < n)
+			z0[first + l] = (t_complex){regs.re[data->start.result][l],
+				regs.im[data->start.result][l]};
+		first += n;
+	}
+}
+
+/**
+ * @brief Fills the free lanes with the next pixels of the batch
+ *
+ * @details The c-only setup of the program is then run again over the whole
+ * group: recomputing the lanes already in flight gives the values they hold,
+ * and refills only happen once half the group is free.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the step program
+ * @param[in] batch Batch of points
+ * @param[in] z0 Initial z of each pixel of the batch
+ * @param[in,out] vm Lane group
+ */
+static void	vm_refill(t_data *data, t_pixel_batch *batch, const t_complex *z0,
+				t_vm_lanes *vm)
+{
+	while (vm->active < VM_LANES && vm->next < batch->count)
+	{
+		vm->pixel[vm->active] = vm->next;
+		vm->left[vm->active] = vm->cap;
+		vm->regs.re[0][vm->active] = z0[vm->next].real;
+		vm->regs.im[0][vm->active] = z0[vm->next].imag;
+		vm->regs.re[1][vm->active] = batch->real[vm->next];
+		vm->regs.im[1][vm->active++] = batch->imag[vm->next++];
+	}
+	vm_run(data->step.code, data->step.setup, &vm->regs, vm->active);
+}
+
+/**
+ * @brief Retires the lanes that escaped or reached the cap
+ *
+ * @details Counts follow the built-in kernels: the iterations left when
+ * |z| exceeds VM_BAILOUT, or 0 for points that never do. The squared moduli
+ * of all lanes are computed up front by the batch operations. A finished
+ * lane is replaced by the last active one, registers included.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] program Step program, giving the registers in use
+ * @param[in,out] batch Batch receiving the escape counts
+ * @param[in,out] vm Lane group
+ */
+static void	vm_retire(const t_program *program, t_pixel_batch *batch,
+				t_vm_lanes *vm)
+{
+	double	norm[VM_LANES];
+	int		escaped;
+	int		last;
+	int		l;
+	int		r;
+
+	complex_ops()->norm(norm, (t_complex_soa){vm->regs.re[0],
+		vm->regs.im[0]}, vm->active);
+	l = 0;
+	while (l < vm->active)
+	{
+		vm->left[l]--;
+		escaped = norm[l] > VM_BAILOUT * VM_BAILOUT;
+		if (!escaped && vm->left[l] > 0)
+		{
+			l++;
+			continue ;
+		}
+		batch->iter[vm->pixel[l]] = 0;
+		if (escaped)
+			batch->iter[vm->pixel[l]] = vm->left[l];
+		last = --vm->active;
+		vm->pixel[l] = vm->pixel[last];
+		vm->left[l] = vm->left[last];
+		norm[l] = norm[last];
+		r = -1;
+		while (++r < program->nregs)
+		{
+			vm->regs.re[r][l] = vm->regs.re[r][last];
+			vm->regs.im[r][l] = vm->regs.im[r][last];
+		}
+	}
+}
+
+/**
+ * @brief Computes the escape counts of a batch with the user formula
+ *
+ * @details Iterates z = step(z, c) from the start program's value, with the
+ * pixel as c. Each round runs the loop part of the step over the active
+ * lanes, moves the result into z and retires the finished lanes.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the compiled programs
+ * @param[in,out] batch Batch of points, receiving their escape counts
+ */
+void	vm_batch(t_data *data, t_pixel_batch *batch)
+{
+	t_vm_lanes		vm;
+	t_complex		z0[RENDER_TILE * RENDER_TILE];
+	const t_program	*step;
+	const t_formula	*formula;
+	int				l;
+
+	step = &data->step;
+	formula = fractal_formula(data->type);
+	vm_start(data, batch, z0);
+	vm_load_constants(step, &vm.regs);
+	vm.cap = formula_cap(data, formula->base, formula->scaled);
+	vm.active = 0;
+	vm.next = 0;
+	while (vm.active || vm.next < batch->count)
+	{
+		if (vm.active <= VM_LANES / 2 && vm.next < batch->count)
+			vm_refill(data, batch, z0, &vm);
+		vm_run(step->code + step->setup, step->len - step->setup, &vm.regs,
+			vm.active);
+		l = -1;
+		while (++l < vm.active)
+		{
+			vm.regs.re[0][l] = vm.regs.re[step->result][l];
+			vm.regs.im[0][l] = vm.regs.im[step->result][l];
+		}
+		vm_retire(step, batch, &vm);
+	}
+}
+
+/**
+ * @brief Computes the escape count of one sample with the user formula
+ *
+ * @details Used where samples are taken one at a time, such as
+ * supersampling and tile rendering.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the compiled programs
+ * @param[in] point Sample, used as c
+ *
+ * @return int Escape count, as returned by the built-in kernels
+ */
+int	vm_escape(t_data *data, t_complex point)
+{
+	t_pixel_batch	batch;
+
+	batch.count = 1;
+	batch.real[0] = point.real;
+	batch.imag[0] = point.imag;
+	vm_batch(data, &batch);
+	return (batch.iter[0]);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file formulas.c
+ * @brief Registry of the fractal formulas and their specialized kernels
+ *
+ * @details Each formula is one FORMULA_KERNELS line and one registry entry.
+ * Adding a formula takes a new t_fractals value, its kernels and its entry
+ * here; the renderer, the command line, the tile server and the colouring
+ * all read it from the registry. The "formula" entry runs the step given on
+ * the command line, compiled by vm_compile().
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "formula.h"
+
+/** Classic Mandelbrot set: z = z² + c */
+FORMULA_KERNELS(mandelbrot, cx_add(cx_mul(z, z), c), 2.0, ITER, 1, 0)
+
+/** Julia set: z = z² + c with c fixed by the user */
+FORMULA_KERNELS(julia, cx_add(cx_mul(z, z), c), 2.0, ITER, 1, 1)
+
+/** Sinh variant: z = sinh(z / c), with a fixed iteration cap */
+FORMULA_KERNELS(sinh, cx_sinh_tier(cx_div(z, c), tier), 2.0, ITER, 0, 0)
+
+/** Eye variant: z = z³ + 1/c */
+FORMULA_KERNELS(eye, cx_add(cx_mul(cx_mul(z, z), z), cx_inv(c)), 2.0, ITER,
+	1, 0)
+
+/** Dragon variant: z = sinh(z) + 1/c², with a wide bailout and deep cap */
+FORMULA_KERNELS(dragon, cx_add(cx_sinh_tier(z, tier), cx_inv(cx_mul(c, c))),
+	60.0, ITER * 20, 1, 0)
+
+/* User formulas are compiled at start-up and run by formula_vm.c */
+
+/**
+ * @brief Returns the registry entry of a fractal type
+ *
+ * @details Entries are stored in t_fractals order. Unknown types fall back
+ * to the Mandelbrot set. Symmetries are declared where every image of the
+ * formula has them: orbits starting at a real z and iterating a map that
+ * commutes with conjugation give conjugate images for conjugate c, and
+ * Julia sets of z² + c take z and -z to the same orbit. The sinh variant
+ * starts at i, whose orbit for the conjugate c is the negated conjugate,
+ * of the same modulus. Starting points such as the one of the dragon break
+ * the symmetry. Only the formulas calling the tiered sinh are marked
+ * tiered; the others, user formulas included, give the same escape counts
+ * at every tier.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] type Fractal type
+ *
+ * @return const t_formula* Description and kernels of the formula
+ */
+const t_formula	*fractal_formula(t_fractals type)
+{
+	static const t_formula	formulas[FRACTAL_COUNT] = {
+	{"mandelbrot", MANDELBROT, 0, 0, {0, 0}, ITER, 1, 0, 1,
+		MIRROR_CONJUGATE, 0, mandelbrot_escape, mandelbrot_batch,
+		mandelbrot_orbit},
+	{"julia", JULIA, 1, 0, {0, 0}, ITER, 1, 0, 0,
+		MIRROR_ROTATION, 0, julia_escape, julia_batch, julia_orbit},
+	{"sinh", SINH_MANDELBROT, 0, 0, {0, 1}, ITER, 0, 1, 1,
+		MIRROR_CONJUGATE, 1, sinh_escape, sinh_batch, sinh_orbit},
+	{"eye", EYE_MANDELBROT, 0, 0, {0, 0}, ITER, 1, 0, 1,
+		MIRROR_CONJUGATE, 0, eye_escape, eye_batch, eye_orbit},
+	{"dragon", DRAGON_MANDELBROT, 0, 0, {1, 0.1}, ITER * 20, 1, 0, 1,
+		MIRROR_NONE, 1, dragon_escape, dragon_batch, dragon_orbit},
+	{"formula", USER_FORMULA, 0, 1, {0, 0}, ITER, 1, 0, 1,
+		MIRROR_NONE, 0, vm_escape, vm_batch, NULL}
+	};
+
+	if ((unsigned int)type >= FRACTAL_COUNT)
+		type = MANDELBROT;
+	return (&formulas[type]);
+}
+
+/**
+ * @brief Looks a formula up by its command-line name
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] name Name given on the command line or in a tile request
+ *
+ * @return const t_formula* Registry entry, or NULL for an unknown name
+ */
+const t_formula	*formula_by_name(const char *name)
+{
+	int	i;
+
+	i = -1;
+	while (++i < FRACTAL_COUNT)
+		if (str_compare_all(name, fractal_formula(i)->name))
+			return (fractal_formula(i));
+	return (NULL);
+}
@@ -9,90 +9,84 @@
 #include "fract_ol.h"
 
 /**
- * @brief Maps screen coordinates to complex plane and renders Mandelbrot fractal
+ * @brief Maps screen coordinates to the complex plane
  *
- * @details Transforms pixel coordinates to complex plane coordinates taking
- * into account the current zoom level and viewing window. The complex number
- * becomes the C parameter in the Mandelbrot iteration z = z² + c.
+ * @details Transforms a (possibly fractional) pixel position to complex plane
+ * coordinates taking into account the current zoom level and viewing window.
+ * Fractional positions are used to take sub-pixel samples when supersampling.
+ * The resulting number is the c parameter for Mandelbrot variants and the
+ * initial z value for Julia sets.
  *
  * @ingroup fractal_render
  *
- * @param[in,out] data Pointer to application state with viewing parameters
- * @param[in] screen_pos Screen pixel coordinates to be mapped
+ * @param[in] data Pointer to application state with viewing parameters
+ * @param[in] x Horizontal screen coordinate in pixels
+ * @param[in] y Vertical screen coordinate in pixels
+ *
+ * @return t_complex Complex plane point under the given screen position
  */
-static void	calculate_c_off(t_data *data, t_vector2 screen_pos)
+t_complex	screen_to_complex(t_data *data, double x, double y)
 {
-	t_complex	c;
-
-	c.real = (double)screen_pos.x / SCREEN_WIDTH - 0.5;
-	c.real *= data -> max.real - data -> min.real;
-	c.real += data -> min.real;
-	c.imag = (double)screen_pos.y / SCREEN_HEIGHT - 0.5;
-	c.imag *= data -> max.imag - data -> min.imag;
-	c.imag *= (double)SCREEN_HEIGHT / SCREEN_WIDTH;
-	c.imag += data -> min.imag;
-	draw_mandelbrot(data, c, screen_pos);
+	t_complex	point;
+
+	point.real = x / SCREEN_WIDTH - 0.5;
+	point.real *= data -> max.real - data -> min.real;
+	point.real += data -> min.real;
+
+	point.imag = y / SCREEN_HEIGHT - 0.5;
+	point.imag *= data -> max.imag - data -> min.imag;
+	point.imag *= (double)SCREEN_HEIGHT / SCREEN_WIDTH;
+	point.imag += data -> min.imag;
+	return (point);
 }
 
 /**
- * @brief Maps screen coordinates to complex plane and renders Julia set fractal
+ * @brief Dispatches a complex point to the escape function of the fractal
  *
- * @details Transforms pixel coordinates to the initial Z value for Julia set
- * iteration. The C parameter is fixed and provided by the user at program start.
- * Iteration formula is z_{n+1} = z_n² + c where c remains constant.
+ * @details Runs the escape kernel of the formula registered for the fractal
+ * type. For Julia formulas the point is the initial z; for the Mandelbrot
+ * variants it is the c parameter.
  *
  * @ingroup fractal_render
  *
- * @param[in,out] data Pointer to application state with viewing parameters
- * @param[in] screen_pos Screen pixel coordinates to be mapped
+ * @param[in] data Pointer to application state with the fractal type
+ * @param[in] point Complex plane point to be tested
+ *
+ * @return int Remaining iterations when divergence detected, or 0 if bounded
  */
-static void	calculate_z(t_data *data, t_vector2 screen_pos)
+int	fractal_escape(t_data *data, t_complex point)
 {
-	t_complex	z;
-
-	z.real = (double)screen_pos.x / SCREEN_WIDTH - 0.5;
-	z.real *= data -> max.real - data -> min.real;
-	z.real += data -> min.real;
-	z.imag = (double)screen_pos.y / SCREEN_HEIGHT - 0.5;
-	z.imag *= data -> max.imag - data -> min.imag;
-	z.imag *= (double)SCREEN_HEIGHT / SCREEN_WIDTH;
-	z.imag += data -> min.imag;
-	draw_julia(data, z, screen_pos);
+	return (fractal_formula(data->type)->escape(data, point));
 }
 
 /**
- * @brief Maps coordinates and dispatches to appropriate Mandelbrot variant
+ * @brief Dispatches an escape count to the colour scheme of the fractal
  *
- * @details Transforms screen coordinates to complex plane and determines which
- * Mandelbrot variant to render based on the fractal type. Handles Sinh, Eye,
- * and Dragon variants, each with different iteration formulas.
+ * @details Each formula registers its own colouring rules (psychedelic or
+ * HSV, black interior or not), normalised by its zoom-scaled iteration
+ * count. Separating colouring from iteration lets the escape counts be
+ * stored and reused without iterating again. Colour cycling advances the
+ * phase of both schemes.
  *
  * @ingroup fractal_render
  *
- * @param[in,out] data Pointer to application state with viewing parameters
- * @param[in] screen_pos Screen pixel coordinates to be mapped
+ * @param[in] data Pointer to application state with the fractal type
+ * @param[in] dives Escape count returned by fractal_escape
+ *
+ * @return int 32-bit ARGB color for the escape count
  */
-static void	calculate_c(t_data *data, t_vector2 screen_pos)
+int	fractal_shade(t_data *data, int dives)
 {
-	t_complex	c;
-
-	c.real = (double)screen_pos.x / SCREEN_WIDTH - 0.5;
-	c.real *= data -> max.real - data -> min.real;
-	c.real += data -> min.real;
+	const t_formula	*formula;
 
-	c.imag = (double)screen_pos.y / SCREEN_HEIGHT - 0.5;
-	c.imag *= data -> max.imag - data -> min.imag;
-	c.imag *= (double)SCREEN_HEIGHT / SCREEN_WIDTH;
-	c.imag += data -> min.imag;
-
-	if (data -> type == SINH_MANDELBROT)
-		draw_sinh_mandelbrot(data, c, screen_pos);
-
-	else if (data -> type == EYE_MANDELBROT)
-		draw_eye_mandelbrot(data, c, screen_pos);
-
-	else if (data -> type == DRAGON_MANDELBROT)
-		draw_dragon_mandelbrot(data, c, screen_pos);
+	formula = fractal_formula(data->type);
+	if (dives <= 0 && formula->black_interior)
+		return (0);
+	if (formula->hsv)
+		return (get_color_hsv(dives,
+				calculate_iterations(data, formula->base), data->cycle.phase));
+	return (psychedelic_color(dives, data->color_off,
+			calculate_iterations(data, formula->base)));
 }
 
 /**
@@ -102,6 +96,11 @@ static void	calculate_c(t_data *data, t_vector2 screen_pos)
  * scale relative to zoom level. Higher zoom levels reveal finer detail and
  * require more iterations to accurately determine convergence or divergence.
  * Formula: iterations = max_iter * log₂(zoom_factor + 1)
+ * When the adaptive iteration controller is enabled, its time-budgeted scale
+ * (and the idle refinement boost) replaces the logarithmic zoom term. A fixed
+ * multiplier set in data->iter_factor, such as the one of a tile level, takes
+ * precedence over both. Julia morph previews scale the result down by
+ * MORPH_ITER_SCALE.
  *
  * @ingroup fractal_render
  *
@@ -112,17 +111,121 @@ static void	calculate_c(t_data *data, t_vector2 screen_pos)
  */
 int	calculate_iterations(t_data *data, int max_iter)
 {
-	return (max_iter * log2(data->zoom_factor + 1));
+	int	iter;
+
+	if (data->iter_factor > 0)
+		iter = max_iter * data->iter_factor;
+	else if (data->iter_ctrl.enabled)
+		iter = max_iter * data->iter_ctrl.scale * data->iter_ctrl.boost;
+	else
+		iter = max_iter * log2(data->zoom_factor + 1);
+	if (data->morph.moving)
+		iter *= MORPH_ITER_SCALE;
+	return (iter);
+}
+
+/**
+ * @brief Returns the iteration cap used by the current fractal type
+ *
+ * @details Mirrors the iteration cap of the formula kernels. Escape counts
+ * never exceed this value, which sizes the colour palette of a frame and
+ * lets the worker threads tell which escape counts are close to the cap
+ * when reporting feedback to the adaptive iteration controller.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the fractal type
+ *
+ * @return int Maximum iteration count of the current fractal type
+ */
+int	iteration_cap(t_data *data)
+{
+	const t_formula	*formula;
+
+	formula = fractal_formula(data->type);
+	if (formula->scaled)
+		return (calculate_iterations(data, formula->base));
+	return (formula->base);
+}
+
+/**
+ * @brief Records whether a pixel hit or nearly hit the iteration cap
+ *
+ * @details Pixels with an escape count of 0 reached the cap. Pixels that still
+ * escaped but used more than 15/16 of the available iterations are counted as
+ * late: they are the ones whose colour would change with a deeper cap, while
+ * interior points stay capped no matter how many iterations are spent.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] thread_data Worker state receiving the counters
+ * @param[in] dives Escape count returned by fractal_escape
+ * @param[in] cap Iteration cap of the current fractal type
+ */
+void	count_escape(t_thread_data *thread_data, int dives, int cap)
+{
+	if (dives <= 0)
+		thread_data->capped++;
+	else if (dives * 16 <= cap)
+		thread_data->late++;
+}
+
+/**
+ * @brief Writes the results of a batch back to the frame in one pass
+ *
+ * @details Stores the escape counts in the iteration buffer and their
+ * palette colours in the render target row by row, and updates the worker
+ * escape counters. Rows outside the bound region of the render target are
+ * only kept in the iteration buffer.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] thread_data Worker state receiving the counters
+ * @param[in] batch Batch with its escape counts computed
+ * @param[in] cap Iteration cap of the current fractal type
+ */
+static void	store_batch(t_thread_data *thread_data, const t_pixel_batch *batch,
+				int cap)
+{
+	t_data		*data;
+	Uint32		*row;
+	const int	*iter;
+	int			x;
+	int			y;
+
+	data = thread_data->data;
+	y = -1;
+	while (++y < batch->area.h)
+	{
+		iter = batch->iter + y * batch->area.w;
+		mem_copy(data->iters + (batch->area.y + y) * SCREEN_WIDTH
+			+ batch->area.x, iter, batch->area.w * sizeof(int));
+		row = NULL;
+		if (batch->area.y + y >= data->frame.y
+			&& batch->area.y + y < data->frame.y + data->frame.h)
+			row = (Uint32 *)((Uint8 *)data->pixels + (batch->area.y + y
+						- data->frame.y) * data->pitch);
+		x = -1;
+		while (++x < batch->area.w)
+		{
+			if (row && batch->area.x + x >= data->frame.x
+				&& batch->area.x + x < data->frame.x + data->frame.w)
+				row[batch->area.x + x - data->frame.x] = palette_color(data,
+						iter[x]);
+			count_escape(thread_data, iter[x], cap);
+		}
+	}
 }
 
 /**
  * @brief Thread worker function that renders a horizontal section of the fractal
  *
- * @details Each thread is responsible for computing a range of scanlines.
- * Iterates through assigned rows and columns, maps each pixel to complex
- * coordinates, and dispatches to the appropriate fractal rendering function
- * based on the current fractal type. This function runs in parallel across
- * NUM_THREADS worker threads.
+ * @details Each thread is responsible for computing a range of scanlines,
+ * split into RENDER_TILE squares visited in Morton order. The points of a
+ * square are gathered into a structure-of-arrays batch, the escape kernel
+ * runs over the whole batch, and the escape counts and their colours,
+ * looked up in the frame palette, are written back in one pass. This
+ * function runs in parallel across every worker thread.
  *
  * @ingroup fractal_render
  *
@@ -133,67 +236,114 @@ int	calculate_iterations(t_data *data, int max_iter)
 void	*render_fractal_threaded(void *arg)
 {
 	t_thread_data	*thread_data;
-	t_data			*data;
-	t_vector2		screen_pos;
+	t_pixel_batch	batch;
+	t_vector2		squares;
+	t_vector2		square;
+	unsigned int	index;
+	unsigned int	side;
+	int				cap;
 
 	thread_data = (t_thread_data *)arg;
-	data = thread_data->data;
-
-	screen_pos.y = thread_data->start_y - 1;
-	screen_pos.x = -1;
-
-	while (++screen_pos.y < thread_data->end_y)
+	cap = iteration_cap(thread_data->data);
+	squares.x = (thread_data->end_x - thread_data->start_x + RENDER_TILE - 1)
+		/ RENDER_TILE;
+	squares.y = (thread_data->end_y - thread_data->start_y + RENDER_TILE - 1)
+		/ RENDER_TILE;
+	side = 1;
+	while (side < (unsigned int)squares.x || side < (unsigned int)squares.y)
+		side <<= 1;
+	index = 0;
+	while (index < side * side)
 	{
-		screen_pos.x = -1;
-
-		while (++screen_pos.x < SCREEN_WIDTH)
-		{
+		square = morton_decode(index++);
+		if (square.x >= squares.x || square.y >= squares.y)
+			continue ;
+		square.x = thread_data->start_x + square.x * RENDER_TILE;
+		square.y = thread_data->start_y + square.y * RENDER_TILE;
+		batch_gather(thread_data->data, (SDL_Rect){square.x, square.y,
+			fmin(RENDER_TILE, thread_data->end_x - square.x),
+			fmin(RENDER_TILE, thread_data->end_y - square.y)}, &batch);
+		fractal_escape_batch(thread_data->data, &batch);
+		store_batch(thread_data, &batch, cap);
+	}
+	return (NULL);
+}
 
-			if (data->type == MANDELBROT)
-				calculate_c_off(data, screen_pos);
+/**
+ * @brief Sums the worker escape counters and reports the finished frame
+ *
+ * @details Collects the capped and late pixel counts of every worker and
+ * hands them, together with the elapsed render time, to the adaptive
+ * iteration controller.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the controller
+ * @param[in] thread_data Array of finished worker states, one per thread
+ * @param[in] start Performance counter value taken when the frame started
+ */
+static void	report_frame(t_data *data, t_thread_data *thread_data, Uint64 start)
+{
+	int		capped;
+	int		late;
+	double	ms;
+	int		i;
 
-			else if (data->type == JULIA)
-				calculate_z(data, screen_pos);
-			else if (data->type == SINH_MANDELBROT
-				|| data->type == EYE_MANDELBROT
-				|| data->type == DRAGON_MANDELBROT)
-				calculate_c(data, screen_pos);
-		}
+	capped = 0;
+	late = 0;
+	i = -1;
+	while (++i < data->cpu.threads)
+	{
+		capped += thread_data[i].capped;
+		late += thread_data[i].late;
 	}
-	return (NULL);
+	ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0
+		/ SDL_GetPerformanceFrequency();
+	iter_ctrl_feedback(data, ms, capped, late);
 }
 
 /**
- * @brief Orchestrates multi-threaded fractal rendering across all worker threads
+ * @brief Runs a worker routine over a screen area on all worker threads
  *
- * @details Divides the screen into horizontal strips and spawns NUM_THREADS
- * worker threads to compute each section in parallel. Distributes remaining
- * rows evenly if screen height is not perfectly divisible. Blocks until all
- * threads complete their work before returning. Called whenever the view changes
- * due to zoom or parameter adjustments.
+ * @details Divides the area into horizontal strips and spawns one worker
+ * thread per detected CPU running the given routine, each on its own section.
+ * Worker i always takes the i-th strip and, when pinning is enabled, always
+ * runs on the same core.
+ * Distributes remaining rows evenly if the area height is not perfectly
+ * divisible. Blocks until all threads complete their work before returning,
+ * so the per-thread counters can be read by the caller.
  *
  * @ingroup fractal_render
  *
- * @param[in,out] data Pointer to application state with all rendering parameters
+ * @param[in,out] data Pointer to application state shared by all workers
+ * @param[in] area Screen rectangle to process
+ * @param[in] routine Worker function receiving a t_thread_data pointer
+ * @param[out] thread_data Array of MAX_THREADS worker states to fill in
  */
-void	redraw_fractal(t_data *data)
+void	run_threaded(t_data *data, SDL_Rect area, void *(*routine)(void *),
+			t_thread_data *thread_data)
 {
-	pthread_t		threads[NUM_THREADS];
-	t_thread_data	thread_data[NUM_THREADS];
+	pthread_t		threads[MAX_THREADS];
+	pthread_attr_t	attr;
 	int				rows_per_thread;
 	int				remaining_rows;
 	int				i;
 
-	rows_per_thread = SCREEN_HEIGHT / NUM_THREADS;
-	remaining_rows = SCREEN_HEIGHT % NUM_THREADS;
+	rows_per_thread = area.h / data->cpu.threads;
+	remaining_rows = area.h % data->cpu.threads;
 
 	i = -1;
-	while (++i < NUM_THREADS)
+	while (++i < data->cpu.threads)
 	{
 		thread_data[i].data = data;
 		thread_data[i].thread_id = i;
-		thread_data[i].start_y = i * rows_per_thread;
-		thread_data[i].end_y = (i + 1) * rows_per_thread;
+		thread_data[i].capped = 0;
+		thread_data[i].late = 0;
+		thread_data[i].refined = 0;
+		thread_data[i].start_x = area.x;
+		thread_data[i].end_x = area.x + area.w;
+		thread_data[i].start_y = area.y + i * rows_per_thread;
+		thread_data[i].end_y = area.y + (i + 1) * rows_per_thread;
 
 		if (i < remaining_rows)
 		{
@@ -206,11 +356,61 @@ void	redraw_fractal(t_data *data)
 			thread_data[i].end_y += remaining_rows;
 		}
 
-		pthread_create(&threads[i], NULL, render_fractal_threaded,
-			&thread_data[i]);
+		cpu_thread_attr(&data->cpu, &attr, i);
+		pthread_create(&threads[i], &attr, routine, &thread_data[i]);
+		pthread_attr_destroy(&attr);
 	}
 
 	i = -1;
-	while (++i < NUM_THREADS)
+	while (++i < data->cpu.threads)
 		pthread_join(threads[i], NULL);
 }
+
+/**
+ * @brief Orchestrates multi-threaded fractal rendering across all worker threads
+ *
+ * @details Binds the render target, builds the colour palette of the frame
+ * and gives every pixel its escape count through symmetry_render, which
+ * computes them on all worker threads and mirrors those an axis of
+ * symmetry of the formula allows. Called whenever the view changes due to
+ * zoom or parameter adjustments. The frame time and the escape counters
+ * gathered by the workers are reported to the adaptive iteration
+ * controller. While the tile cache is enabled, the view is instead composed
+ * from cached tiles, computing only the missing ones. When supersampling is
+ * enabled, a second pass refines the pixels whose escape counts differ
+ * sharply from their neighbours. In orbit density mode the accumulated
+ * image is only discarded, and rebuilt by the idle passes;
+ * exports still render the escape-time view.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with all rendering parameters
+ */
+void	redraw_fractal(t_data *data)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+	Uint64			start;
+
+	data->pan_x = 0;
+	data->pan_y = 0;
+	if (data->density.enabled && !data->pixels)
+	{
+		density_reset(data);
+		return ;
+	}
+	tile_fetch(data);
+	if (build_palette(data) || frame_begin(data))
+		return ;
+	start = SDL_GetPerformanceCounter();
+	if (data->tiles.enabled)
+		run_threaded(data, data->frame, tile_compose_threaded, thread_data);
+	else
+	{
+		symmetry_render(data, data->frame, thread_data);
+		report_frame(data, thread_data, start);
+	}
+	data->iters_cap = iteration_cap(data);
+	if (data->supersample)
+		supersample_fractal(data);
+	frame_end(data);
+}
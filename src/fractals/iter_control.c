@@ -0,0 +1,170 @@
+/**
+ * @file iter_control.c
+ * @brief Time-budgeted adaptive iteration controller
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Initializes the adaptive iteration controller in its disabled state
+ *
+ * @details The controller starts disabled so the default behaviour keeps the
+ * zoom-based logarithmic iteration cap. Scale and boost start at 1.0.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[out] data Pointer to application state holding the controller
+ */
+void	iter_ctrl_init(t_data *data)
+{
+	data->iter_ctrl.enabled = 0;
+	data->iter_ctrl.scale = 1.0;
+	data->iter_ctrl.boost = 1.0;
+	data->iter_ctrl.last_ms = 0.0;
+	data->iter_ctrl.late = 0.0;
+	data->iter_ctrl.last_input = 0;
+}
+
+/**
+ * @brief Enables or disables the adaptive iteration controller
+ *
+ * @details When enabled, the controller starts from the cap the zoom-based
+ * formula would give, so the toggle does not produce a visual jump, and then
+ * adapts it from frame feedback. The view is marked for redrawing with the
+ * new cap.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state holding the controller
+ */
+void	iter_ctrl_toggle(t_data *data)
+{
+	data->iter_ctrl.enabled = !data->iter_ctrl.enabled;
+	data->iter_ctrl.scale = log2(data->zoom_factor + 1);
+	if (data->iter_ctrl.scale < 1.0)
+		data->iter_ctrl.scale = 1.0;
+	data->iter_ctrl.boost = 1.0;
+	if (data->iter_ctrl.enabled)
+		print_format("\033[0;92mAdaptive iterations enabled\n\033[0;39m");
+	else
+		print_format("\033[0;93mAdaptive iterations disabled\n\033[0;39m");
+	iter_ctrl_input(data);
+	data->needs_redraw = 1;
+}
+
+/**
+ * @brief Notifies the controller that the user interacted with the view
+ *
+ * @details Restarts the idle timer and drops any idle refinement boost so the
+ * next frame is rendered with the interactive, time-budgeted cap again.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state holding the controller
+ */
+void	iter_ctrl_input(t_data *data)
+{
+	data->iter_ctrl.last_input = session_ticks(data);
+	data->iter_ctrl.boost = 1.0;
+}
+
+/**
+ * @brief Updates the iteration scale from the statistics of a finished frame
+ *
+ * @details The late fraction is the share of escaping pixels that needed more
+ * than 15/16 of the cap; a high value means the cap is cutting off detail.
+ * A frame over FRAME_BUDGET_MS shrinks the scale proportionally. A frame with
+ * headroom and many late pixels grows it, at most by the remaining budget.
+ * A frame with almost no late pixels decays it slowly. Frames rendered during
+ * idle refinement only record their statistics.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state holding the controller
+ * @param[in] ms Render time of the frame in milliseconds
+ * @param[in] capped Number of pixels that reached the iteration cap
+ * @param[in] late Number of pixels that escaped near the iteration cap
+ */
+void	iter_ctrl_feedback(t_data *data, double ms, int capped, int late)
+{
+	t_iter_ctrl	*ctrl;
+	int			escaped;
+	double		growth;
+
+	ctrl = &data->iter_ctrl;
+	escaped = SCREEN_WIDTH * SCREEN_HEIGHT - capped;
+	if (escaped < 1)
+		escaped = 1;
+	ctrl->last_ms = ms;
+	ctrl->late = (double)late / escaped;
+	if (!ctrl->enabled || ctrl->boost > 1.0)
+		return ;
+	if (ms > FRAME_BUDGET_MS)
+		ctrl->scale *= fmax(0.5, FRAME_BUDGET_MS / ms);
+	else if (ctrl->late > 0.002)
+	{
+		growth = FRAME_BUDGET_MS / fmax(ms * 1.25, 1.0);
+		ctrl->scale *= fmin(1.5, fmax(1.0, growth));
+	}
+	else if (ctrl->late < 0.0002)
+		ctrl->scale *= 0.95;
+	ctrl->scale = fmin(fmax(ctrl->scale, 0.25), ITER_SCALE_MAX);
+}
+
+/**
+ * @brief Time left before the next idle refinement
+ *
+ * @details Lets the event loop sleep until the refinement is due instead of
+ * polling for it.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state holding the controller
+ *
+ * @return int Milliseconds to wait, 0 if due now, -1 if nothing to refine
+ */
+int	iter_ctrl_due(t_data *data)
+{
+	t_iter_ctrl	*ctrl;
+	Uint32		idle;
+
+	ctrl = &data->iter_ctrl;
+	if (!ctrl->enabled
+		|| ctrl->late < 0.0002
+		|| ctrl->scale * ctrl->boost * 2 > ITER_SCALE_MAX
+		|| ctrl->last_ms * 2 > FRAME_BUDGET_MS * 25)
+		return (-1);
+	idle = session_ticks(data) - ctrl->last_input;
+	if (idle >= IDLE_REFINE_MS)
+		return (0);
+	return (IDLE_REFINE_MS - idle);
+}
+
+/**
+ * @brief Deepens the iteration cap once the view has been idle
+ *
+ * @details Called from the event loop. After IDLE_REFINE_MS without input,
+ * doubles the boost factor and re-renders while pixels keep escaping near the
+ * cap. Refinement stops when the detail no longer improves, when the total
+ * multiplier reaches ITER_SCALE_MAX or when a single refinement frame gets
+ * too slow to keep the application responsive.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state holding the controller
+ *
+ * @return int Whether a refinement frame was rendered
+ * @retval 1 The view was re-rendered with a deeper cap
+ * @retval 0 Nothing to refine
+ */
+int	iter_ctrl_refine(t_data *data)
+{
+	if (iter_ctrl_due(data))
+		return (0);
+	data->iter_ctrl.boost *= 2;
+	redraw_fractal(data);
+	return (1);
+}
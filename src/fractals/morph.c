@@ -0,0 +1,279 @@
+/**
+ * @file morph.c
+ * @brief Interactive Julia morphing driven by the pointer position
+ *
+ * @details While morphing is on, every pointer motion picks a new Julia
+ * constant. The event loop renders it as a preview with one sample per
+ * MORPH_BLOCK² pixels and a shallower iteration cap, which keeps up with
+ * the pointer, and renders it in full once the pointer stops. A preview is
+ * computed band by band; when newer motion is already queued between two
+ * bands, the preview is dropped unseen and the newer constant rendered
+ * instead, so the display never lags behind the pointer.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Puts the morphing state in its disabled state
+ *
+ * @ingroup fractal_render
+ *
+ * @param[out] morph Julia morphing state
+ */
+void	morph_init(t_morph *morph)
+{
+	morph->enabled = 0;
+	morph->moving = 0;
+	morph->dirty = 0;
+	morph->last_move = 0;
+	morph->previews = 0;
+	morph->cancelled = 0;
+}
+
+/**
+ * @brief Prints the current Julia constant
+ *
+ * @details Printed in the form the command line takes, so an interesting
+ * constant can be reopened with ./fractol julia.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the Julia constant
+ * @param[in] state Text printed before the constant
+ */
+static void	morph_print(t_data *data, const char *state)
+{
+	char	text[96];
+
+	snprintf(text, sizeof(text), "%.6f %.6f", data->initial_c.real,
+		data->initial_c.imag);
+	print_format("\033[0;92m%s (julia %s, %d previews, %d cancelled)\n"
+		"\033[0;39m", state, text, data->morph.previews,
+		data->morph.cancelled);
+}
+
+/**
+ * @brief Enables or disables Julia morphing
+ *
+ * @details Only formulas whose sample is the starting z have a constant to
+ * morph. Disabling prints the constant reached and marks the view for a
+ * full render if it still shows a preview.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the morphing state
+ */
+void	morph_toggle(t_data *data)
+{
+	t_morph	*morph;
+
+	morph = &data->morph;
+	if (!fractal_formula(data->type)->julia)
+	{
+		print_format("\033[0;91mJulia morphing needs a Julia set\n"
+			"\033[0;39m");
+		return ;
+	}
+	morph->enabled = !morph->enabled;
+	if (morph->enabled)
+	{
+		morph->previews = 0;
+		morph->cancelled = 0;
+		print_format("\033[0;92mJulia morphing enabled\n\033[0;39m");
+		return ;
+	}
+	morph->dirty = 0;
+	morph_print(data, "Julia morphing disabled");
+	if (!morph->moving)
+		return ;
+	morph->moving = 0;
+	data->needs_redraw = 1;
+}
+
+/**
+ * @brief Sets the Julia constant from the pointer position
+ *
+ * @details Called for every pointer motion while morphing is on. Only the
+ * constant is updated here; the event loop renders the last one once all
+ * pending events are drained.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the Julia constant
+ * @param[in] x Horizontal pointer position in pixels
+ * @param[in] y Vertical pointer position in pixels
+ */
+void	morph_follow(t_data *data, int x, int y)
+{
+	if (!data->morph.enabled)
+		return ;
+	data->initial_c.real = ((double)x / SCREEN_WIDTH * 2 - 1) * MORPH_SPAN;
+	data->initial_c.imag = ((double)y / SCREEN_HEIGHT * 2 - 1) * MORPH_SPAN
+		* SCREEN_HEIGHT / SCREEN_WIDTH;
+	data->morph.dirty = 1;
+	data->morph.last_move = session_ticks(data);
+}
+
+/**
+ * @brief Thread worker computing a coarse preview of its strip
+ *
+ * @details Blocks start on multiples of MORPH_BLOCK; each worker takes the
+ * blocks whose first row lies in its strip, samples their top-left pixel
+ * and stores its escape count over the whole block.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] arg Pointer to the t_thread_data of this worker
+ *
+ * @return void* Always NULL
+ */
+static void	*morph_preview_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+	t_data			*data;
+	t_vector2		pos;
+	int				dives;
+	int				i;
+
+	thread_data = (t_thread_data *)arg;
+	data = thread_data->data;
+	pos.y = (thread_data->start_y + MORPH_BLOCK - 1) / MORPH_BLOCK
+		* MORPH_BLOCK;
+	while (pos.y < thread_data->end_y)
+	{
+		pos.x = thread_data->start_x;
+		while (pos.x < thread_data->end_x)
+		{
+			dives = fractal_escape(data, screen_to_complex(data, pos.x, pos.y));
+			i = -1;
+			while (++i < MORPH_BLOCK * MORPH_BLOCK)
+				if (pos.y + i / MORPH_BLOCK < SCREEN_HEIGHT
+					&& pos.x + i % MORPH_BLOCK < SCREEN_WIDTH)
+					data->iters[(pos.y + i / MORPH_BLOCK) * SCREEN_WIDTH
+						+ pos.x + i % MORPH_BLOCK] = dives;
+			pos.x += MORPH_BLOCK;
+		}
+		pos.y += MORPH_BLOCK;
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Tells whether newer pointer motion is already queued
+ *
+ * @details Previews run on the render thread while the event loop keeps
+ * pumping events, so the queue is current without pumping it here.
+ *
+ * @return int 1 if a motion event is pending, 0 otherwise
+ *
+ * @ingroup fractal_render
+ */
+static int	morph_superseded(void)
+{
+	SDL_Event	event;
+
+	return (SDL_PeepEvents(&event, 1, SDL_PEEKEVENT, SDL_MOUSEMOTION,
+			SDL_MOUSEMOTION) > 0);
+}
+
+/**
+ * @brief Renders a coarse preview of the latest Julia constant
+ *
+ * @details Escape counts of the shown area are computed into the iteration
+ * buffer band by band, at MORPH_ITER_SCALE of the iteration cap, and only
+ * coloured into
+ * the texture once every band is done. If newer pointer motion arrives in
+ * between, the preview is dropped: the texture is left untouched and the
+ * next round of the event loop renders the newer constant. Orbit density
+ * images only restart their accumulation.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the morphing state
+ *
+ * @return int Whether the preview was shown
+ * @retval 1 Preview shown
+ * @retval 0 Preview dropped for a newer constant
+ */
+int	morph_preview(t_data *data)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+	int				rows;
+	int				band;
+
+	data->morph.dirty = 0;
+	data->morph.moving = 1;
+	if (data->density.enabled)
+	{
+		redraw_fractal(data);
+		return (1);
+	}
+	rows = (data->shown.h / MORPH_BANDS + MORPH_BLOCK - 1) / MORPH_BLOCK
+		* MORPH_BLOCK;
+	band = 0;
+	while (band * rows < data->shown.h)
+	{
+		run_threaded(data, (SDL_Rect){data->shown.x, data->shown.y + band
+			* rows, data->shown.w, fmin(rows, data->shown.h - band * rows)},
+			morph_preview_threaded, thread_data);
+		band++;
+		if (band * rows < data->shown.h && morph_superseded())
+		{
+			data->morph.cancelled++;
+			return (0);
+		}
+	}
+	data->iters_cap = iteration_cap(data);
+	if (build_palette(data) || frame_begin(data))
+		return (1);
+	run_threaded(data, data->frame, recolor_threaded, thread_data);
+	frame_end(data);
+	data->morph.previews++;
+	return (1);
+}
+
+/**
+ * @brief Time left before a morph preview is refined
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the morphing state
+ *
+ * @return int Milliseconds to wait, 0 if due now, -1 if no preview shown
+ */
+int	morph_due(t_data *data)
+{
+	Uint32	still;
+
+	if (!data->morph.moving)
+		return (-1);
+	still = session_ticks(data) - data->morph.last_move;
+	if (still >= MORPH_SETTLE_MS)
+		return (0);
+	return (MORPH_SETTLE_MS - still);
+}
+
+/**
+ * @brief Renders the current constant in full once the pointer stops
+ *
+ * @details Called from the event loop while no new constant is pending.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the morphing state
+ *
+ * @return int Whether the full render ran
+ * @retval 1 The preview was replaced by a full render
+ * @retval 0 Nothing to refine yet
+ */
+int	morph_settle(t_data *data)
+{
+	if (morph_due(data))
+		return (0);
+	data->morph.moving = 0;
+	redraw_fractal(data);
+	return (1);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file pan.c
+ * @brief Incremental re-rendering of panned views
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Shifts the iteration buffer by a whole number of pixels
+ *
+ * @details Moves every stored escape count that stays in the shown area to
+ * its new position, so pixel (x, y) receives the count of pixel
+ * (x - dx, y - dy). Counts outside the shown area are neither read nor
+ * written. Rows are walked in the direction that never overwrites a row
+ * before it has been copied, and memmove handles the overlap inside a row.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the iteration buffer
+ * @param[in] dx Horizontal shift in pixels (positive moves content right)
+ * @param[in] dy Vertical shift in pixels (positive moves content down)
+ */
+static void	shift_iters(t_data *data, int dx, int dy)
+{
+	SDL_Rect	area;
+	int			y;
+	int			step;
+
+	area = data->shown;
+	y = area.y + area.h - 1;
+	step = -1;
+	if (dy < 0)
+	{
+		y = area.y;
+		step = 1;
+	}
+	while (y >= area.y && y < area.y + area.h)
+	{
+		if (y - dy >= area.y && y - dy < area.y + area.h)
+			memmove(data->iters + y * SCREEN_WIDTH + area.x + (dx > 0) * dx,
+				data->iters + (y - dy) * SCREEN_WIDTH + area.x
+				+ (dx < 0) * -dx, (area.w - abs(dx)) * sizeof(int));
+		y += step;
+	}
+}
+
+/**
+ * @brief Thread worker recolouring stored escape counts of a screen section
+ *
+ * @details Writes the palette colour of every stored escape count in the
+ * assigned area, clipped to the bound frame, without iterating any fractal
+ * formula. Used for the part of a panned view that was already computed
+ * before the shift, to show Julia morph previews once all their bands are
+ * computed, and for every frame of colour cycling, so rows are walked
+ * directly with the palette lookup inlined.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] arg Pointer to t_thread_data structure containing thread parameters
+ *
+ * @return void* Always returns NULL (required by pthread interface)
+ */
+void	*recolor_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+	t_data			*data;
+	Uint32			*row;
+	int				*iters;
+	t_vector2		pos;
+	t_vector2		end;
+	int				dives;
+
+	thread_data = (t_thread_data *)arg;
+	data = thread_data->data;
+	end.x = fmin(thread_data->end_x, data->frame.x + data->frame.w);
+	end.y = fmin(thread_data->end_y, data->frame.y + data->frame.h);
+	pos.y = fmax(thread_data->start_y, data->frame.y) - 1;
+	while (++pos.y < end.y)
+	{
+		row = (Uint32 *)((Uint8 *)data->pixels
+				+ (pos.y - data->frame.y) * data->pitch);
+		iters = data->iters + pos.y * SCREEN_WIDTH;
+		pos.x = fmax(thread_data->start_x, data->frame.x) - 1;
+		while (++pos.x < end.x)
+		{
+			dives = iters[pos.x];
+			if (dives < 0)
+				dives = 0;
+			else if (dives >= data->palette_len)
+				dives = data->palette_len - 1;
+			row[pos.x - data->frame.x] = data->palette[dives];
+		}
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Renders the view after a pan, computing only newly exposed pixels
+ *
+ * @details Applies the pan accumulated since the last frame. The iteration
+ * buffer is shifted by the integer pixel offset and the region that stayed
+ * on screen is recoloured from it; workers run the fractal formula only on
+ * the vertical and horizontal strips that were uncovered. All of it stays
+ * within the shown area. Offsets larger than that area fall back to a full
+ * redraw, and so do pans while the tile
+ * cache is enabled, since composing from tiles already skips every cached
+ * sample and keeps the view aligned to the tile grid, and in orbit density
+ * mode, whose orbits cross the whole screen. So do pans after the
+ * iteration cap changed (the first drag after an idle refinement, or after
+ * a morph preview): escape counts are the iterations left under the cap
+ * they were computed with, so the kept area would not match the exposed
+ * strips. The back slot of the frame ring holds an older frame, so the
+ * whole frame is bound and every pixel rewritten.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the pending pan
+ */
+void	pan_fractal(t_data *data)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+	SDL_Rect		area;
+	SDL_Rect		kept;
+	SDL_Rect		exposed;
+
+	area = data->shown;
+	if (data->tiles.enabled || data->density.enabled
+		|| data->iters_cap != iteration_cap(data)
+		|| abs(data->pan_x) >= area.w || abs(data->pan_y) >= area.h)
+	{
+		redraw_fractal(data);
+		return ;
+	}
+	shift_iters(data, data->pan_x, data->pan_y);
+	kept = (SDL_Rect){area.x + (data->pan_x > 0) * data->pan_x,
+		area.y + (data->pan_y > 0) * data->pan_y, area.w - abs(data->pan_x),
+		area.h - abs(data->pan_y)};
+	if (build_palette(data) || frame_begin(data))
+		return ;
+	run_threaded(data, kept, recolor_threaded, thread_data);
+	exposed = (SDL_Rect){area.x + (data->pan_x < 0) * kept.w, area.y,
+		abs(data->pan_x), area.h};
+	if (exposed.w)
+		run_threaded(data, exposed, render_fractal_threaded, thread_data);
+	exposed = (SDL_Rect){kept.x, area.y + (data->pan_y < 0) * kept.h, kept.w,
+		abs(data->pan_y)};
+	if (exposed.h)
+		run_threaded(data, exposed, render_fractal_threaded, thread_data);
+	data->pan_x = 0;
+	data->pan_y = 0;
+	if (data->supersample)
+		supersample_fractal(data);
+	frame_end(data);
+}
@@ -0,0 +1,270 @@
+/**
+ * @file split.c
+ * @brief Linked Mandelbrot and Julia split view
+ *
+ * @details The window is split in two panes: the Mandelbrot view on the
+ * left and, on the right, the Julia set of the c under the pointer. The
+ * pane is a second application state with the Julia formula, its own
+ * texture and escape counts, so every renderer works on it unchanged. Both
+ * panes show the central half of their screen, and their shown area limits
+ * every render and upload to that half. While the pointer
+ * moves over the Mandelbrot pane, the Julia pane is previewed coarsely and
+ * refined once the pointer rests, exactly like Julia morphing.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Sets up the Julia pane from the main view
+ *
+ * @details Copies the main state, then gives the pane the Julia formula, a
+ * view of SPLIT_SPAN centred on the origin, the central half of the screen
+ * as shown area and resources of its own. The
+ * tile cache, iteration controller and other modes start disabled. In a
+ * headless replay there is no renderer, and the pane has no texture.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to the main application state
+ * @param[out] pane Pane state to fill in
+ *
+ * @return int Status of the operation
+ * @retval 0 Pane ready
+ * @retval 1 Texture or buffer allocation failed
+ */
+static int	split_open(t_data *data, t_data *pane)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+
+	*pane = *data;
+	pane->type = JULIA;
+	pane->initial_c = screen_to_complex(data, SCREEN_WIDTH / 2,
+			SCREEN_HEIGHT / 2);
+	pane->min = (t_complex){0, 0};
+	pane->max = (t_complex){SPLIT_SPAN, SPLIT_SPAN};
+	pane->zoom_factor = 1.0;
+	pane->supersample = 0;
+	pane->iter_factor = 0;
+	pane->pixels = NULL;
+	pane->bound = 0;
+	pane->shown = (SDL_Rect){SCREEN_WIDTH / 4, 0, SCREEN_WIDTH / 2,
+		SCREEN_HEIGHT};
+	pane->present = 0;
+	pane->needs_redraw = 0;
+	pane->needs_export = 0;
+	pane->pan_x = 0;
+	pane->pan_y = 0;
+	pane->palette = NULL;
+	pane->palette_len = 0;
+	pane->palette_size = 0;
+	pane->split.pane = NULL;
+	pane->iters = NULL;
+	pane->iters_cap = -1;
+	pane->texture = NULL;
+	arena_init(&pane->scratch, 0, 0);
+	if (arena_init(&pane->buffers, (size_t)SCREEN_WIDTH * SCREEN_HEIGHT
+			* sizeof(Uint32) * (FRAME_SLOTS + 1), 0)
+		|| frame_ring_init(&pane->ring, &pane->buffers))
+		return (1);
+	iter_ctrl_init(pane);
+	tile_cache_init(&pane->tiles, 0);
+	density_init(&pane->density);
+	morph_init(&pane->morph);
+	cycle_init(&pane->cycle);
+	pane->iters = (int *)arena_alloc(&pane->buffers,
+			SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(int));
+	pane->texture = SDL_CreateTexture(data->renderer, SDL_PIXELFORMAT_ARGB8888,
+			SDL_TEXTUREACCESS_STREAMING, SCREEN_WIDTH, SCREEN_HEIGHT);
+	if (!pane->iters || (data->renderer && !pane->texture))
+		return (1);
+	run_threaded(pane, (SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT},
+		first_touch_threaded, thread_data);
+	return (0);
+}
+
+/**
+ * @brief Releases the Julia pane and returns to the single view
+ *
+ * @details The main view shows the whole screen again and is marked for
+ * redrawing, since only its central half was kept up to date.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to the main application state
+ */
+void	split_close(t_data *data)
+{
+	t_data	*pane;
+
+	pane = data->split.pane;
+	data->split.pane = NULL;
+	data->split.focus = 0;
+	if (!pane)
+		return ;
+	data->shown = (SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+	data->needs_redraw = 1;
+	if (pane->texture)
+		SDL_DestroyTexture(pane->texture);
+	arena_free(&pane->buffers);
+	free(pane->palette);
+	free(pane);
+	data->present = 1;
+}
+
+/**
+ * @brief Enables or disables the linked Mandelbrot and Julia view
+ *
+ * @details Only the Mandelbrot set has its Julia sets in the registry. The
+ * pane opens on the Julia set of the centre of the view, marked for
+ * redrawing so that the render thread draws it. From then on, the main
+ * view only renders the central half it shows, like the pane.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to the main application state
+ */
+void	split_toggle(t_data *data)
+{
+	t_data	*pane;
+
+	if (data->split.pane)
+	{
+		split_close(data);
+		print_format("\033[0;93mLinked view disabled\n\033[0;39m");
+		return ;
+	}
+	if (data->type != MANDELBROT)
+	{
+		print_format("\033[0;91mLinked view needs the Mandelbrot set\n"
+			"\033[0;39m");
+		return ;
+	}
+	pane = (t_data *)malloc(sizeof(t_data));
+	data->split.pane = pane;
+	if (!pane || split_open(data, pane))
+	{
+		split_close(data);
+		print_format("\033[0;91mLinked view allocation failed\n\033[0;39m");
+		return ;
+	}
+	print_format("\033[0;92mLinked view enabled\n\033[0;39m");
+	data->shown = pane->shown;
+	pane->needs_redraw = 1;
+	data->present = 1;
+}
+
+/**
+ * @brief Returns the pane under a window column and its texture column
+ *
+ * @details Input handlers use it to zoom and pan the pane under the
+ * pointer. Without the linked view the window maps to the main view.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to the main application state
+ * @param[in,out] x Window column, replaced by the column of the pane
+ *
+ * @return t_data* State of the pane under the column
+ */
+t_data	*split_target(t_data *data, int *x)
+{
+	if (!data->split.pane)
+		return (data);
+	if (*x >= SCREEN_WIDTH / 2)
+	{
+		*x += SCREEN_WIDTH / 4 - SCREEN_WIDTH / 2;
+		return (data->split.pane);
+	}
+	*x += SCREEN_WIDTH / 4;
+	return (data);
+}
+
+/**
+ * @brief Follows the pointer in the linked view
+ *
+ * @details The pane under the pointer takes focus. Over the Mandelbrot
+ * pane, the point under the pointer becomes the constant of the Julia
+ * pane, which is previewed on the next round of the event loop.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to the main application state
+ * @param[in] x Horizontal pointer position in the window
+ * @param[in] y Vertical pointer position in the window
+ */
+void	split_follow(t_data *data, int x, int y)
+{
+	t_data	*pane;
+
+	pane = data->split.pane;
+	if (!pane)
+		return ;
+	data->split.focus = (split_target(data, &x) == pane);
+	if (data->split.focus)
+		return ;
+	pane->initial_c = screen_to_complex(data, x, y);
+	pane->morph.dirty = 1;
+	pane->morph.last_move = session_ticks(data);
+}
+
+/**
+ * @brief Renders the pending work of the Julia pane
+ *
+ * @details Zooms and pans of the pane come first, then the preview of a
+ * new constant, then its full render once the pointer has rested for
+ * MORPH_SETTLE_MS. The event loop calls it before the main view while the
+ * pane has focus and after it otherwise.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to the main application state
+ *
+ * @return int Whether the pane rendered anything
+ */
+int	split_refresh(t_data *data)
+{
+	t_data	*pane;
+
+	pane = data->split.pane;
+	if (!pane)
+		return (0);
+	if (pane->needs_redraw)
+	{
+		pane->needs_redraw = 0;
+		redraw_fractal(pane);
+	}
+	else if (pane->pan_x || pane->pan_y)
+		pan_fractal(pane);
+	else if (pane->morph.dirty)
+		morph_preview(pane);
+	else if (!morph_settle(pane))
+		return (0);
+	return (1);
+}
+
+/**
+ * @brief Copies both panes of the linked view to the window
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to the main application state
+ *
+ * @return int 1 if the linked view was drawn, 0 without it
+ */
+int	split_present(t_data *data)
+{
+	SDL_Rect	src;
+	SDL_Rect	dst;
+
+	if (!data->split.pane)
+		return (0);
+	src = data->shown;
+	dst = (SDL_Rect){0, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT};
+	SDL_RenderCopy(data->renderer, data->texture, &src, &dst);
+	dst.x = SCREEN_WIDTH / 2;
+	SDL_RenderCopy(data->renderer, data->split.pane->texture, &src, &dst);
+	return (1);
+}
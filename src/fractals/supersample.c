@@ -0,0 +1,186 @@
+/**
+ * @file supersample.c
+ * @brief Adaptive supersampling of high-variance pixels
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Returns a deterministic pseudo-random offset for a sub-sample
+ *
+ * @details Hashes the pixel position and sub-sample index into a value in
+ * [0, 1). Being deterministic, the same view always produces the same
+ * anti-aliased image, which keeps exports reproducible.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] x Horizontal screen coordinate of the pixel
+ * @param[in] y Vertical screen coordinate of the pixel
+ * @param[in] s Index of the random value requested for this pixel
+ *
+ * @return double Jitter value in the range [0, 1)
+ */
+static double	jitter(int x, int y, int s)
+{
+	unsigned int	h;
+
+	h = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u
+		^ (unsigned int)s * 83492791u;
+	h ^= h >> 13;
+	h *= 0x5bd1e995u;
+	h ^= h >> 15;
+	return ((h & 0xFFFF) / 65536.0);
+}
+
+/**
+ * @brief Tells whether a pixel lies on a sharp escape count transition
+ *
+ * @details Compares the escape count of the pixel with its eight neighbours
+ * in the iteration buffer. Pixels inside flat regions or smooth colour bands
+ * are left alone; only those differing by more than SUPERSAMPLE_THRESHOLD
+ * from a neighbour are worth extra samples.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with the iteration buffer
+ * @param[in] x Horizontal screen coordinate of the pixel
+ * @param[in] y Vertical screen coordinate of the pixel
+ *
+ * @return int Boolean result of the test
+ * @retval 1 The pixel needs supersampling
+ * @retval 0 The pixel lies in a flat region
+ */
+static int	is_high_variance(t_data *data, int x, int y)
+{
+	int	center;
+	int	dx;
+	int	dy;
+
+	center = data->iters[y * SCREEN_WIDTH + x];
+	dy = -2;
+	while (++dy <= 1)
+	{
+		dx = -2;
+		while (++dx <= 1)
+		{
+			if (x + dx < 0 || x + dx >= SCREEN_WIDTH
+				|| y + dy < 0 || y + dy >= SCREEN_HEIGHT)
+				continue ;
+			if (abs(data->iters[(y + dy) * SCREEN_WIDTH + x + dx] - center)
+				> SUPERSAMPLE_THRESHOLD)
+				return (1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * @brief Computes the anti-aliased colour of a pixel
+ *
+ * @details Splits the pixel footprint into a SUPERSAMPLE_GRID square grid and
+ * takes one jittered sample inside every cell (stratified sampling). The
+ * colours of all samples are averaged channel by channel.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] data Pointer to application state with viewing parameters
+ * @param[in] x Horizontal screen coordinate of the pixel
+ * @param[in] y Vertical screen coordinate of the pixel
+ *
+ * @return int Averaged 32-bit ARGB color of the pixel
+ */
+static int	supersample_pixel(t_data *data, int x, int y)
+{
+	int		rgb[3];
+	int		color;
+	int		s;
+	double	sx;
+	double	sy;
+
+	rgb[0] = 0;
+	rgb[1] = 0;
+	rgb[2] = 0;
+	s = -1;
+	while (++s < SUPERSAMPLE_GRID * SUPERSAMPLE_GRID)
+	{
+		sx = x - 0.5 + (s % SUPERSAMPLE_GRID + jitter(x, y, s * 2))
+			/ SUPERSAMPLE_GRID;
+		sy = y - 0.5 + (s / SUPERSAMPLE_GRID + jitter(x, y, s * 2 + 1))
+			/ SUPERSAMPLE_GRID;
+		color = palette_color(data,
+				fractal_escape(data, screen_to_complex(data, sx, sy)));
+		rgb[0] += (color >> 16) & 0xFF;
+		rgb[1] += (color >> 8) & 0xFF;
+		rgb[2] += color & 0xFF;
+	}
+	s = SUPERSAMPLE_GRID * SUPERSAMPLE_GRID;
+	return (255 << 24 | (rgb[0] / s) << 16 | (rgb[1] / s) << 8 | rgb[2] / s);
+}
+
+/**
+ * @brief Thread worker refining the high-variance pixels of a screen section
+ *
+ * @details Scans the rows assigned to the thread and replaces the colour of
+ * every pixel on a sharp escape count transition with its supersampled
+ * colour. The iteration buffer is only read, so neighbour tests across strip
+ * borders are safe while other workers run.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] arg Pointer to t_thread_data structure containing thread parameters
+ *
+ * @return void* Always returns NULL (required by pthread interface)
+ */
+static void	*supersample_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+	t_vector2		pos;
+
+	thread_data = (t_thread_data *)arg;
+	pos.y = thread_data->start_y - 1;
+	while (++pos.y < thread_data->end_y)
+	{
+		pos.x = thread_data->start_x - 1;
+		while (++pos.x < thread_data->end_x)
+		{
+			if (!is_high_variance(thread_data->data, pos.x, pos.y))
+				continue ;
+			my_mlx_pixel_put(thread_data->data, pos,
+				supersample_pixel(thread_data->data, pos.x, pos.y));
+			thread_data->refined++;
+		}
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Anti-aliases the current frame by supersampling only where needed
+ *
+ * @details Must run after a 1x render has filled the iteration buffer, while
+ * its render target is still bound, since it rewrites pixels in place. Only
+ * the pixels whose escape counts differ sharply from a neighbour receive
+ * SUPERSAMPLE_GRID² jittered sub-samples; flat regions, which cover most of
+ * a typical view, keep their single sample.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with a rendered frame
+ *
+ * @return int Number of pixels that were supersampled
+ */
+int	supersample_fractal(t_data *data)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+	int				refined;
+	int				i;
+
+	run_threaded(data, data->frame, supersample_threaded, thread_data);
+	refined = 0;
+	i = -1;
+	while (++i < data->cpu.threads)
+		refined += thread_data[i].refined;
+	return (refined);
+}
@@ -0,0 +1,272 @@
+/**
+ * @file symmetry.c
+ * @brief Mirroring of the views across an axis of symmetry
+ *
+ * @details Formulas declare the symmetry of their images in the registry:
+ * the Mandelbrot variants starting at a real z are symmetric about the real
+ * axis and the Julia sets under a half turn about the origin. When the
+ * axis, or the centre, lies on screen, the pixels on one side whose mirror
+ * image is also on screen are copied from it instead of computed, which
+ * saves up to half of the kernel work of views across the axis. The view
+ * is first moved by under half a pixel so that the axis falls on a pixel
+ * row or midway between two, making every copy exact.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Locates the axis of symmetry along one screen axis
+ *
+ * @details Pixel p maps to the coordinate (p - size / 2) * step + min, so
+ * the pixels p and axis - p map to opposite coordinates when
+ * axis = size - 2 * min / step. The axis is rounded to the nearest integer,
+ * which snap moves the view onto.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] min Coordinate at the centre of the screen
+ * @param[in] max Other end of the span of the view
+ * @param[in] size Pixels of the screen along the axis
+ *
+ * @return int Sum of the positions of mirrored pixels, -1 if off screen
+ */
+static int	symmetry_axis(double min, double max, int size)
+{
+	double	step;
+	double	axis;
+
+	step = (max - min) / SCREEN_WIDTH;
+	if (!(step > 0))
+		return (-1);
+	axis = size - 2 * min / step;
+	if (!(axis >= 0 && axis <= 2 * size))
+		return (-1);
+	return ((int)lround(axis));
+}
+
+/**
+ * @brief Moves the view so that an axis of symmetry falls on the grid
+ *
+ * @details Shifts both ends of the view by the same amount, under half a
+ * pixel, keeping its span. Axes already within SYMMETRY_EPSILON of the grid
+ * are left alone, so aligned views stay bitwise stable across redraws.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] min Coordinate at the centre of the screen
+ * @param[in,out] max Other end of the span of the view
+ * @param[in] size Pixels of the screen along the axis
+ * @param[in] axis Rounded axis returned by symmetry_axis
+ */
+static void	symmetry_snap(double *min, double *max, int size, int axis)
+{
+	double	step;
+	double	offset;
+
+	step = (*max - *min) / SCREEN_WIDTH;
+	offset = size - 2 * *min / step - axis;
+	if (fabs(offset) <= SYMMETRY_EPSILON)
+		return ;
+	*min += offset * step / 2;
+	*max += offset * step / 2;
+}
+
+/**
+ * @brief Range of the pixels of a span whose mirror image is in the span
+ *
+ * @details With below set, only the pixels past the axis are kept, so each
+ * mirrored pair is copied one way.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] axis Sum of the positions of mirrored pixels
+ * @param[in] from First pixel of the span
+ * @param[in] len Pixels in the span
+ * @param[in] below Keep only the pixels past the axis
+ * @param[out] range First and last pixel, empty if range[0] > range[1]
+ */
+static void	symmetry_range(int axis, int from, int len, int below,
+				int *range)
+{
+	range[0] = fmax(from, axis - (from + len - 1));
+	if (below)
+		range[0] = fmax(range[0], axis / 2 + 1);
+	range[1] = fmin(from + len - 1, axis - from);
+}
+
+/**
+ * @brief Finds the part of an area that can be mirrored
+ *
+ * @details Looks up the symmetry of the formula and the pixels of the area
+ * below the axis whose mirror image also lies in the area. When there are
+ * any, the view is aligned on the axis and the band of mirrored pixels is
+ * stored in data->symmetry; a half turn needs both the row and the column
+ * of the centre to be near enough.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the view
+ * @param[in] area Screen area about to be rendered
+ *
+ * @return int Whether part of the area can be mirrored
+ * @retval 1 The band is set and the view aligned
+ * @retval 0 Every pixel must be computed
+ */
+int	symmetry_align(t_data *data, SDL_Rect area)
+{
+	t_symmetry	*symmetry;
+	int			rows[2];
+	int			cols[2];
+
+	symmetry = &data->symmetry;
+	symmetry->mirror = fractal_formula(data->type)->symmetry;
+	symmetry->axis.y = symmetry_axis(data->min.imag, data->max.imag,
+			SCREEN_HEIGHT);
+	symmetry->axis.x = symmetry_axis(data->min.real, data->max.real,
+			SCREEN_WIDTH);
+	symmetry_range(symmetry->axis.y, area.y, area.h, 1, rows);
+	cols[0] = area.x;
+	cols[1] = area.x + area.w - 1;
+	if (symmetry->mirror == MIRROR_ROTATION)
+		symmetry_range(symmetry->axis.x, area.x, area.w, 0, cols);
+	if (symmetry->mirror == MIRROR_NONE || symmetry->axis.y < 0
+		|| (symmetry->mirror == MIRROR_ROTATION && symmetry->axis.x < 0)
+		|| rows[0] > rows[1] || cols[0] > cols[1])
+	{
+		symmetry->mirror = MIRROR_NONE;
+		return (0);
+	}
+	symmetry->band = (SDL_Rect){cols[0], rows[0], cols[1] - cols[0] + 1,
+		rows[1] - rows[0] + 1};
+	symmetry_snap(&data->min.imag, &data->max.imag, SCREEN_HEIGHT,
+		symmetry->axis.y);
+	if (symmetry->mirror == MIRROR_ROTATION)
+		symmetry_snap(&data->min.real, &data->max.real, SCREEN_WIDTH,
+			symmetry->axis.x);
+	return (1);
+}
+
+/**
+ * @brief Thread worker copying the mirror image of its strip of the band
+ *
+ * @details Stores the escape counts of the mirrored pixels and their
+ * palette colours, clipped to the bound region of the render target, and
+ * counts them like computed pixels so the iteration controller sees the
+ * whole frame.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in] arg Pointer to the t_thread_data of this worker
+ *
+ * @return void* Always NULL
+ */
+static void	*symmetry_mirror_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+	t_data			*data;
+	Uint32			*row;
+	t_vector2		pos;
+	int				source;
+	int				dives;
+	int				cap;
+
+	thread_data = (t_thread_data *)arg;
+	data = thread_data->data;
+	cap = iteration_cap(data);
+	pos.y = thread_data->start_y - 1;
+	while (++pos.y < thread_data->end_y)
+	{
+		row = NULL;
+		if (pos.y >= data->frame.y && pos.y < data->frame.y + data->frame.h)
+			row = (Uint32 *)((Uint8 *)data->pixels + (pos.y - data->frame.y)
+					* data->pitch);
+		pos.x = thread_data->start_x - 1;
+		while (++pos.x < thread_data->end_x)
+		{
+			source = pos.x;
+			if (data->symmetry.mirror == MIRROR_ROTATION)
+				source = data->symmetry.axis.x - pos.x;
+			dives = data->iters[(data->symmetry.axis.y - pos.y) * SCREEN_WIDTH
+				+ source];
+			data->iters[pos.y * SCREEN_WIDTH + pos.x] = dives;
+			if (row && pos.x >= data->frame.x
+				&& pos.x < data->frame.x + data->frame.w)
+				row[pos.x - data->frame.x] = palette_color(data, dives);
+			count_escape(thread_data, dives, cap);
+		}
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Runs one pass over a rectangle and adds up its escape counters
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state
+ * @param[in] rect Screen rectangle of the pass, skipped when empty
+ * @param[in] routine Worker function of the pass
+ * @param[in,out] total Worker states receiving the summed counters
+ */
+static void	symmetry_pass(t_data *data, SDL_Rect rect,
+				void *(*routine)(void *), t_thread_data *total)
+{
+	t_thread_data	pass[MAX_THREADS];
+	int				i;
+
+	if (rect.w <= 0 || rect.h <= 0)
+		return ;
+	run_threaded(data, rect, routine, pass);
+	i = -1;
+	while (++i < data->cpu.threads)
+	{
+		total[i].capped += pass[i].capped;
+		total[i].late += pass[i].late;
+	}
+}
+
+/**
+ * @brief Renders an area, mirroring what its symmetry allows
+ *
+ * @details Without a mirrored band, the area is rendered as one pass.
+ * Otherwise the rows above and below the band and the columns beside it
+ * are computed first, which includes every source of the band, and the
+ * band is then copied from them. The escape counters of all the passes are
+ * summed into thread_data, as a single pass would leave them.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[in,out] data Pointer to application state with the view
+ * @param[in] area Screen area to render
+ * @param[out] thread_data Array of MAX_THREADS worker states to fill in
+ */
+void	symmetry_render(t_data *data, SDL_Rect area, t_thread_data *thread_data)
+{
+	SDL_Rect	band;
+	int			i;
+
+	if (!symmetry_align(data, area))
+	{
+		run_threaded(data, area, render_fractal_threaded, thread_data);
+		return ;
+	}
+	band = data->symmetry.band;
+	i = -1;
+	while (++i < data->cpu.threads)
+	{
+		thread_data[i].capped = 0;
+		thread_data[i].late = 0;
+	}
+	symmetry_pass(data, (SDL_Rect){area.x, area.y, area.w, band.y - area.y},
+		render_fractal_threaded, thread_data);
+	symmetry_pass(data, (SDL_Rect){area.x, band.y + band.h, area.w, area.y
+		+ area.h - band.y - band.h}, render_fractal_threaded, thread_data);
+	symmetry_pass(data, (SDL_Rect){area.x, band.y, band.x - area.x, band.h},
+		render_fractal_threaded, thread_data);
+	symmetry_pass(data, (SDL_Rect){band.x + band.w, band.y, area.x + area.w
+		- band.x - band.w, band.h}, render_fractal_threaded, thread_data);
+	symmetry_pass(data, band, symmetry_mirror_threaded, thread_data);
+}
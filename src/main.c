@@ -9,44 +9,46 @@
 #include "fract_ol.h"
 
 /**
- * @brief Initializes fractal-specific parameters based on command-line arguments
+ * @brief Selects the fractal type and its parameters by name
  *
- * @details Sets the initial Z value for Mandelbrot variants or the constant C
- * parameter for Julia sets based on the fractal type specified by the user.
- * Each fractal type requires different initial conditions for proper rendering.
+ * @details Shared by the command line and the tile server, which receives
+ * the same names in its request paths. The formula registry gives the type
+ * and, for Mandelbrot variants, the initial z; Julia sets take their
+ * constant from the two strings following the name. User formulas compile
+ * their step and optional initial z, "0" by default. The name must have been
+ * validated with is_mandelbrot(), is_julia() or formula_by_name().
  *
  * @ingroup fractal_render
  *
- * @param[out] data Pointer to application state structure to be initialized
- * @param[in] argv Command-line arguments array containing fractal type and parameters
+ * @param[out] data Pointer to application state structure to be configured
+ * @param[in] args Fractal type name followed by its parameters, if any
+ *
+ * @return int Status of the setup
+ * @retval 0 Fractal ready
+ * @retval 1 A user formula does not compile (message printed)
  */
-static void	initial_variables(t_data *data, char **argv)
+int	fractal_setup(t_data *data, char **args)
 {
-	if (str_compare_all(argv[1], "mandelbrot"))
-	{
-		data -> initial_z.real = 0;
-		data -> initial_z.imag = 0;
-	}
-	else if (str_compare_all(argv[1], "sinh"))
-	{
-		data -> initial_z.real = 0;
-		data -> initial_z.imag = 1;
-	}
-	else if (str_compare_all(argv[1], "eye"))
-	{
-		data -> initial_z.real = 0;
-		data -> initial_z.imag = 0;
-	}
-	else if (str_compare_all(argv[1], "dragon"))
-	{
-		data -> initial_z.real = 1;
-		data -> initial_z.imag = 0.1;
-	}
-	else if (str_compare_all(argv[1], "julia"))
+	const t_formula	*formula;
+
+	formula = formula_by_name(args[0]);
+	data -> type = formula -> type;
+	data -> step.hash = 0;
+	data -> start.hash = 0;
+	if (formula -> julia)
 	{
-		data -> initial_c.real = str_to_float(argv[2]);
-		data -> initial_c.imag = str_to_float(argv[3]);
+		data -> initial_c.real = str_to_float(args[1]);
+		data -> initial_c.imag = str_to_float(args[2]);
 	}
+	else
+		data -> initial_z = formula -> start;
+	if (!formula -> user)
+		return (0);
+	if (vm_compile(&data -> step, args[1]))
+		return (1);
+	if (args[2])
+		return (vm_compile(&data -> start, args[2]));
+	return (vm_compile(&data -> start, "0"));
 }
 
 /**
@@ -54,14 +56,17 @@ static void	initial_variables(t_data *data, char **argv)
  *
  * @details Initializes the complex plane viewing window, zoom factor, color
  * offset, and determines which fractal type to render based on command-line
- * arguments. Delegates to initial_variables for fractal-specific setup.
+ * arguments. Delegates to fractal_setup for fractal-specific setup. The
+ * window renders with the preview accuracy tier.
  *
  * @ingroup fractal_render
  *
  * @param[out] data Pointer to application state structure to be configured
  * @param[in] argv Command-line arguments specifying fractal type and parameters
+ *
+ * @return int Status returned by fractal_setup()
  */
-static void	initial_conditions(t_data *data, char **argv)
+static int	initial_conditions(t_data *data, char **argv)
 {
 	data -> color_off = 0.0;
 	data -> max.real = 0.5;
@@ -69,37 +74,85 @@ static void	initial_conditions(t_data *data, char **argv)
 	data -> min.real = -1;
 	data -> min.imag = -0.5;
 	data -> zoom_factor = 1.0;
-	initial_variables(data, argv);
-	if (str_compare_all(argv[1], "mandelbrot"))
-		data -> type = MANDELBROT;
-	else if (str_compare_all(argv[1], "sinh"))
-		data -> type = SINH_MANDELBROT;
-	else if (str_compare_all(argv[1], "eye"))
-		data -> type = EYE_MANDELBROT;
-	else if (str_compare_all(argv[1], "julia"))
-		data -> type = JULIA;
-	else if (str_compare_all(argv[1], "dragon"))
-		data -> type = DRAGON_MANDELBROT;
+	data -> supersample = 0;
+	data -> iter_factor = 0;
+	data -> tier = TIER_PREVIEW;
+	iter_ctrl_init(data);
+	density_init(&data -> density);
+	morph_init(&data -> morph);
+	cycle_init(&data -> cycle);
+	data -> split.pane = NULL;
+	data -> split.focus = 0;
+	tile_cache_init(&data -> tiles, (size_t)TILE_CACHE_MB << 20);
+	return (fractal_setup(data, argv + 1));
+}
+
+/**
+ * @brief Sets up the render buffers and the rendering state
+ *
+ * @details Maps the frame arenas: the escape count buffer and the frame
+ * ring slots are carved from the buffers arena, and per-round memory comes
+ * from the scratch arena. The buffers arena keeps small pages, so that
+ * each worker writing its own strip of the escape count buffer first
+ * places it on its NUMA node. Shared by the window and by headless
+ * replays, which have no window.
+ *
+ * @ingroup fractal_render
+ *
+ * @param[out] vars Pointer to application state to be initialized
+ *
+ * @return int Status of the operation
+ * @retval 0 Buffers ready
+ * @retval 1 Mapping an arena failed
+ */
+static int	init_buffers(t_data *vars)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+
+	arena_init(&vars->buffers, (size_t)SCREEN_WIDTH * SCREEN_HEIGHT
+		* sizeof(Uint32) * (FRAME_SLOTS + 1), 0);
+	arena_init(&vars->scratch, (size_t)ARENA_SCRATCH_MB << 20, 1);
+	vars->iters = (int *)arena_alloc(&vars->buffers,
+			SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(int));
+	if (!vars->iters || !vars->scratch.base
+		|| frame_ring_init(&vars->ring, &vars->buffers))
+		return (1);
+	run_threaded(vars, (SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT},
+		first_touch_threaded, thread_data);
+	vars->iters_cap = -1;
+	vars->pixels = NULL;
+	vars->pitch = 0;
+	vars->bound = 0;
+	vars->shown = (SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+	vars->present = 0;
+	vars->needs_redraw = 0;
+	vars->needs_export = 0;
+	vars->pan_x = 0;
+	vars->pan_y = 0;
+	vars->palette = NULL;
+	vars->palette_len = 0;
+	vars->palette_size = 0;
+	vars->pipeline.started = 0;
+	vars->running = 1;
+	return (0);
 }
 
 /**
  * @brief Initializes SDL2 subsystems and creates rendering resources
  *
- * @details Creates the SDL2 window, renderer, texture, and pixel buffer.
- * Initializes the mutex for thread-safe pixel writes. Performs error checking
+ * @details Creates the SDL2 window, renderer and streaming texture, then
+ * the render buffers with init_buffers. Performs error checking
  * at each step and exits with an error message if any initialization fails.
  * After successful setup, triggers the initial fractal rendering.
  *
  * @ingroup fractal_render
  *
- * @param[out] vars Pointer to application state structure to be initialized
+ * @param[out] vars Pointer to application state to be initialized
  *
  * @note Exits the application with status 1 if any SDL2 initialization fails
  */
 void	init_window(t_data *vars)
 {
-	pthread_mutex_init(&vars->pixels_mutex, NULL);
-
 	if (SDL_Init(SDL_INIT_VIDEO) < 0)
 	{
 		print_format("\033[0;91mSDL2 initialization failed: %s\n", SDL_GetError());
@@ -153,10 +206,9 @@ void	init_window(t_data *vars)
 		exit(1);
 	}
 
-	vars->pixels = (Uint32 *)malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Uint32));
-	if (!vars->pixels)
+	if (init_buffers(vars))
 	{
-		print_format("\033[0;91mPixel buffer allocation failed\n");
+		print_format("\033[0;91mFrame buffer allocation failed\n");
 		SDL_DestroyTexture(vars->texture);
 		SDL_DestroyRenderer(vars->renderer);
 		SDL_DestroyWindow(vars->window);
@@ -164,19 +216,233 @@ void	init_window(t_data *vars)
 		exit(1);
 	}
 
-	vars->pitch = SCREEN_WIDTH * sizeof(Uint32);
-	vars->running = 1;
-
 	redraw_fractal(vars);
 }
 
+/**
+ * @brief Renders the work left pending by the events of this round
+ *
+ * @details In order: an export of the view, a full redraw after zooms and
+ * toggles, the exposed strips after a pan, a Julia morph preview, the
+ * pending work of the linked Julia pane, then the idle work of the active
+ * mode: the full render of a morphed constant, an orbit density pass, an
+ * adaptive iteration refinement or a frame of colour cycling. The key
+ * handlers only raise these flags, so every render, exports included, runs
+ * on the render thread.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] vars Pointer to application state
+ *
+ * @return int Whether anything was rendered
+ */
+static int	render_pending(t_data *vars)
+{
+	if (vars->needs_export)
+	{
+		vars->needs_export = 0;
+		export_image(vars);
+	}
+	else if (vars->needs_redraw)
+	{
+		vars->needs_redraw = 0;
+		redraw_fractal(vars);
+	}
+	else if (vars->pan_x || vars->pan_y)
+		pan_fractal(vars);
+	else if (vars->morph.dirty)
+		morph_preview(vars);
+	else
+		return (split_refresh(vars) || morph_settle(vars)
+			|| density_refine(vars) || iter_ctrl_refine(vars)
+			|| cycle_step(vars));
+	return (1);
+}
+
+/**
+ * @brief Runs the pending work of one round of the event loop
+ *
+ * @details Posted to the render thread. The scratch arena is reset first:
+ * the previous round is over, and so is everything it allocated there.
+ * The linked Julia pane goes first while it has focus.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] vars Pointer to application state
+ *
+ * @return int Whether anything was rendered
+ */
+static int	render_round(t_data *vars)
+{
+	arena_reset(&vars->scratch);
+	if (vars->split.focus && split_refresh(vars))
+		return (1);
+	return (render_pending(vars));
+}
+
+/**
+ * @brief Returns the earlier of two delays, -1 standing for never
+ *
+ * @ingroup utils
+ *
+ * @param[in] a First delay in milliseconds, or -1
+ * @param[in] b Second delay in milliseconds, or -1
+ *
+ * @return int Earlier delay, -1 if both are -1
+ */
+static int	earliest(int a, int b)
+{
+	if (a < 0 || (b >= 0 && b < a))
+		return (b);
+	return (a);
+}
+
+/**
+ * @brief Sleeps until input arrives or timed idle work is due
+ *
+ * @details Called once a round rendered nothing. The only work that can
+ * then become due without input is the full render of a morph preview, the
+ * adaptive iteration refinement and the next frame of colour cycling;
+ * without any, the loop blocks on the event queue indefinitely.
+ *
+ * @ingroup utils
+ *
+ * @param[in] vars Pointer to application state
+ */
+static void	wait_idle(t_data *vars)
+{
+	int	timeout;
+
+	session_tick(vars);
+	timeout = earliest(iter_ctrl_due(vars), morph_due(vars));
+	timeout = earliest(timeout, cycle_due(vars));
+	if (vars->split.pane)
+		timeout = earliest(timeout, morph_due(vars->split.pane));
+	if (timeout < 0)
+		SDL_WaitEvent(NULL);
+	else if (timeout > 0)
+		SDL_WaitEventTimeout(NULL, timeout);
+}
+
+/**
+ * @brief Applies one input or window event to the application state
+ *
+ * @details Input events advance the session clock and are logged when the
+ * session is recorded; replays feed their logged events through here.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] vars Pointer to application state
+ * @param[in] event Event taken from the SDL queue
+ */
+static void	handle_event(t_data *vars, SDL_Event *event)
+{
+	if (event->type != SDL_QUIT && event->type != SDL_WINDOWEVENT)
+	{
+		session_tick(vars);
+		session_log(vars, event);
+	}
+	if (event->type == SDL_QUIT)
+		vars->running = 0;
+	else if (event->type == SDL_WINDOWEVENT)
+		vars->present = 1;
+	else if (event->type == SDL_KEYDOWN)
+	{
+		iter_ctrl_input(vars);
+		key_handler(event->key.keysym.sym, vars);
+	}
+	else if (event->type == SDL_MOUSEWHEEL)
+	{
+		iter_ctrl_input(vars);
+		wheel_handler(&event->wheel, session_mouse(vars), vars);
+	}
+	else if (event->type == SDL_MOUSEMOTION
+		&& (event->motion.state & SDL_BUTTON_LMASK))
+	{
+		iter_ctrl_input(vars);
+		pan_view(split_target(vars, &event->motion.x),
+			event->motion.xrel, event->motion.yrel);
+	}
+	else if (event->type == SDL_MOUSEMOTION
+		&& (vars->morph.enabled || vars->split.pane))
+	{
+		iter_ctrl_input(vars);
+		morph_follow(vars, event->motion.x, event->motion.y);
+		split_follow(vars, event->motion.x, event->motion.y);
+	}
+}
+
+/**
+ * @brief Handles the window events queued while the render thread works
+ *
+ * @details Only quitting and repaint requests are taken from the queue;
+ * input stays queued until the job is done, since it changes the state the
+ * job is rendering.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] vars Pointer to application state
+ */
+static void	pump_window(t_data *vars)
+{
+	SDL_Event	event;
+
+	SDL_PumpEvents();
+	while (SDL_PeepEvents(&event, 1, SDL_GETEVENT, SDL_QUIT,
+			SDL_WINDOWEVENT) > 0)
+		handle_event(vars, &event);
+}
+
+/**
+ * @brief Presents the newest published frames
+ *
+ * @details Frames are only presented when new or when the window needs
+ * repainting.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] vars Pointer to application state
+ */
+static void	present(t_data *vars)
+{
+	int	fresh;
+
+	fresh = frame_acquire(vars);
+	if (vars->split.pane)
+		fresh |= frame_acquire(vars->split.pane);
+	if (!fresh && !vars->present)
+		return ;
+	vars->present = 0;
+	SDL_RenderClear(vars->renderer);
+	if (!split_present(vars))
+		SDL_RenderCopy(vars->renderer, vars->texture, NULL, NULL);
+	SDL_RenderPresent(vars->renderer);
+}
+
 /**
  * @brief Main event loop processing user input and updating the display
  *
  * @details Continuously polls for SDL2 events including window close, keyboard
- * input, and mouse wheel scrolling. Handles zoom operations by detecting mouse
- * wheel direction and position. Updates the texture and presents the rendered
- * frame to the screen each iteration. Runs until the application is terminated.
+ * input, and mouse wheel scrolling. All pending events are drained before
+ * rendering: zoom steps only update the view, so a burst of wheel events is
+ * composed into a single view transform and only the final view is rendered
+ * once per frame. Dragging with the left button pans the view; when only a
+ * pan is pending, just the newly exposed pixels are computed. While Julia
+ * morphing is on, moving the pointer picks the Julia constant, previewed
+ * coarsely and rendered in full once the pointer stops. In the linked
+ * view, input goes to the pane under the pointer, and the pending work of
+ * the Julia pane is rendered first while it has focus. When idle, the loop
+ * adds orbit density passes in that mode and otherwise, once no input
+ * arrives for a while, lets the adaptive
+ * iteration controller refine the view. The rendering of each round runs on
+ * the render thread; meanwhile the loop sleeps until the job ends, waking
+ * every PUMP_MS to keep the window responsive, and presents every frame
+ * published in the frame ring, so computation and presentation overlap.
+ * Frames are only presented when new or when the window needs repainting.
+ * Once a round renders nothing, the loop blocks on the event queue until
+ * input arrives or timed idle work is due, so an idle view costs no CPU.
+ * Each round freezes the session clock and, when recorded, is logged once
+ * done if it rendered anything. Runs until the application is terminated.
  *
  * @ingroup utils
  *
@@ -185,50 +451,148 @@ void	init_window(t_data *vars)
 void	sdl_loop(t_data *vars)
 {
 	SDL_Event	event;
-	int			mouse_x;
-	int			mouse_y;
 
+	pipeline_start(vars, render_round);
 	while (vars->running)
 	{
-		while (SDL_PollEvent(&event))
+		if (pipeline_busy(vars))
 		{
+			pipeline_wait(vars, PUMP_MS);
+			pump_window(vars);
+		}
+		else
+		{
+			session_log_round(vars);
+			if (!vars->pipeline.worked && !vars->present)
+				wait_idle(vars);
+			while (vars->running && SDL_PollEvent(&event))
+				handle_event(vars, &event);
+			session_round(vars);
+			if (vars->running)
+				pipeline_post(vars);
+		}
+		present(vars);
+	}
+	pipeline_stop(vars);
+}
+
+/**
+ * @brief Renders a replayed session, headless or in a window
+ *
+ * @details Input records go through handle_event and round records run
+ * the work of that round directly, with the session clock set from the
+ * log, so the same frames are rendered in the same order; each is timed
+ * and checked by session_verify. Escape ends the replay instead of
+ * closing the window. Windowed replays present every frame and stop when
+ * the window is closed; headless ones need no display at all.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] vars Pointer to application state
+ * @param[in,out] session Loaded session to replay
+ * @param[in] windowed Whether to show the frames in a window
+ *
+ * @return int Status returned by session_summary(), 1 if setup failed
+ */
+static int	replay(t_data *vars, t_session *session, int windowed)
+{
+	SDL_Event	event;
+	t_record	record;
+	Uint64		start;
 
+	vars->session = session;
+	if (windowed)
+		init_window(vars);
+	else
+	{
+		vars->window = NULL;
+		vars->renderer = NULL;
+		vars->texture = NULL;
+		if (init_buffers(vars))
+			return (1);
+		redraw_fractal(vars);
+	}
+	while (vars->running && session_next(session, &event, &record))
+	{
+		if (record.type == SESSION_ROUND)
+		{
+			start = SDL_GetPerformanceCounter();
+			render_round(vars);
+			session_verify(vars, &record, (double)(SDL_GetPerformanceCounter()
+					- start) * 1000.0 / SDL_GetPerformanceFrequency());
+		}
+		else if (event.type == SDL_KEYDOWN
+			&& event.key.keysym.sym == SDLK_ESCAPE)
+			break ;
+		else
+			handle_event(vars, &event);
+		while (windowed && SDL_PollEvent(&event))
 			if (event.type == SDL_QUIT)
 				vars->running = 0;
+		if (windowed)
+			present(vars);
+	}
+	return (session_summary(session));
+}
 
-			else if (event.type == SDL_KEYDOWN)
-				key_handler(event.key.keysym.sym, vars);
-
-			else if (event.type == SDL_MOUSEWHEEL)
-			{
-				SDL_GetMouseState(&mouse_x, &mouse_y);
-
-				if (event.wheel.direction == SDL_MOUSEWHEEL_NORMAL)
-				{
-
-					if (event.wheel.y > 0)
-						zoom(SDL_BUTTON_LEFT, mouse_x, mouse_y, vars);
-
-					else if (event.wheel.y < 0)
-						zoom(SDL_BUTTON_RIGHT, mouse_x, mouse_y, vars);
-				}
-				else
-				{
-
-					if (event.wheel.y > 0)
-						zoom(SDL_BUTTON_RIGHT, mouse_x, mouse_y, vars);
+/**
+ * @brief Tells whether the arguments name a fractal and its parameters
+ *
+ * @ingroup utils
+ *
+ * @param[in] argc Number of arguments, the program name included
+ * @param[in] argv Arguments in argv form
+ *
+ * @return int 1 if valid, 0 otherwise
+ *
+ * @note Mandelbrot variants take no parameter, Julia sets two and user
+ * formulas a step and an optional initial z
+ */
+static int	valid_fractal(int argc, char **argv)
+{
+	if (argc < 2 || argc > 4 || !formula_by_name(argv[1]))
+		return (0);
+	return (!((is_julia(argv[1]) && argc != 4)
+			|| (is_mandelbrot(argv[1]) && argc != 2)
+			|| (formula_by_name(argv[1])->user && argc < 3)));
+}
 
-					else if (event.wheel.y < 0)
-						zoom(SDL_BUTTON_LEFT, mouse_x, mouse_y, vars);
-				}
-			}
-		}
+/**
+ * @brief Prints the valid command-line parameters
+ *
+ * @details Fractal names are listed from the formula registry.
+ *
+ * @ingroup utils
+ */
+static void	print_usage(void)
+{
+	int	i;
 
-		SDL_UpdateTexture(vars->texture, NULL, vars->pixels, vars->pitch);
-		SDL_RenderClear(vars->renderer);
-		SDL_RenderCopy(vars->renderer, vars->texture, NULL, NULL);
-		SDL_RenderPresent(vars->renderer);
+	print_format("\033[0;91mPlease introduce a valid parameter\n");
+	print_format("\033[0;39mValid parameters:\n");
+	i = -1;
+	while (++i < FRACTAL_COUNT)
+	{
+		print_format("\033[0;9%cm\t%s", "2564"[i % 4],
+			fractal_formula(i)->name);
+		if (fractal_formula(i)->julia)
+			print_format(" \033[0;93mx y");
+		if (fractal_formula(i)->user)
+			print_format(" \033[0;93m\"step\" [\"start\"]");
+		print_format("\n");
 	}
+	print_format("\033[0;97m\tserve \033[0;93m[tcp:port|unix:path]\n");
+	print_format("\033[0;97m\tworker \033[0;93maddress [processes]\n");
+	print_format("\033[0;97m\tcoordinate \033[0;93maddress out.bmp width height"
+		" re im span fractal [x y]\n");
+	print_format("\033[0;97m\tcheck \033[0;93m[views] [seed]\n");
+	print_format("\033[0;97m\trecord \033[0;93mlog.session\033[0;97m fractal"
+		" \033[0;93m[parameters]\n");
+	print_format("\033[0;97m\treplay \033[0;93mlog.session [window]\n");
+	print_format("\033[0;39mOptions, before any parameter:\n");
+	print_format("\033[0;93m\t-t threads\033[0;39m\tworker threads (default:"
+		" available CPUs)\n");
+	print_format("\033[0;93m\t-p\033[0;39m\t\tpin worker threads to cores\n");
 }
 
 /**
@@ -237,43 +601,92 @@ void	sdl_loop(t_data *vars)
  * @details Validates command-line arguments to ensure proper fractal type and
  * parameters are provided. Displays usage information if arguments are invalid.
  * Initializes application state, creates the rendering window, and enters the
- * main event loop. Supports Mandelbrot variants and Julia sets with parameters.
+ * main event loop. Supports Mandelbrot variants, Julia sets with parameters
+ * and user formulas given as expressions of z and c.
+ * "serve" starts the headless tile server instead of a window, "worker" and
+ * "coordinate" the processes of a distributed poster render, and "check"
+ * compares the optimized render paths with a scalar reference. "record"
+ * followed by a log path opens the fractal while logging the session, and
+ * "replay" renders a logged session again, timing every frame. The thread
+ * options "-t <n>" and "-p" may precede any of them.
  *
  * @param[in] argc Number of command-line arguments
  * @param[in] argv Array of command-line argument strings
  *
  * @return 0 on successful execution (never reached due to SDL event loop)
  * @retval 0 Exit after displaying usage information for invalid arguments
+ * @retval 1 The tile server, distributed render or render check failed, a
+ * user formula does not compile, the session cannot be recorded or a replay
+ * left a view unlike its log
  *
  * @note Mandelbrot variants require 2 arguments: program name and fractal type
  * @note Julia sets require 4 arguments: program name, "julia", real part, imaginary part
+ * @note User formulas take 3 or 4 arguments: program name, "formula", step, optional initial z
  */
 int	main(int argc, char **argv)
 {
-	t_data	vars;
+	t_data		vars;
+	t_session	session;
+	char		*record;
+	int			options;
 
-	if (argc < 2 || argc > 4)
+	cpu_detect(&vars.cpu);
+	options = cpu_options(&vars.cpu, argc, argv);
+	if (options < 0)
 	{
-		print_format("\033[0;91mPlease introduce a valid parameter\n");
-		print_format("\033[0;39mValid parameters:\n");
-		print_format("\033[0;92m\tmandelbrot\n");
-		print_format("\033[0;95m\tjulia \033[0;93mx y\n");
-		print_format("\033[0;96m\teye\n");
-		print_format("\033[0;94m\tsinh\n");
+		print_usage();
 		exit(0);
 	}
-	if ((is_julia(argv[1]) && argc != 4) ||
-		(is_mandelbrot(argv[1]) && argc != 2))
+	argc -= options;
+	argv += options;
+	if (argc >= 2 && argc <= 3 && str_compare_all(argv[1], "serve"))
+	{
+		if (argc == 3)
+			return (tile_server(argv[2], &vars.cpu));
+		return (tile_server(SERVER_ADDRESS, &vars.cpu));
+	}
+	if (argc >= 3 && argc <= 4 && str_compare_all(argv[1], "worker"))
 	{
-		print_format("\033[0;91mPlease introduce a valid parameter\n");
-		print_format("\033[0;39mValid parameters:\n");
-		print_format("\033[0;92m\tmandelbrot\n");
-		print_format("\033[0;95m\tjulia \033[0;93mx y\n");
-		print_format("\033[0;96m\teye\n");
-		print_format("\033[0;94m\tsinh\n");
+		if (argc == 4)
+			return (dist_worker(argv[2], str_to_int(argv[3])));
+		return (dist_worker(argv[2], vars.cpu.threads));
+	}
+	if (argc >= 2 && str_compare_all(argv[1], "coordinate"))
+		return (dist_coordinator(argc, argv));
+	if (argc >= 2 && argc <= 4 && str_compare_all(argv[1], "check"))
+		return (render_check(&vars.cpu, argc, argv));
+	if (argc >= 3 && argc <= 4 && str_compare_all(argv[1], "replay")
+		&& (argc == 3 || str_compare_all(argv[3], "window")))
+	{
+		if (session_load(&session, argv[2]))
+			return (1);
+		if (!valid_fractal(session.argc, session.args)
+			|| initial_conditions(&vars, session.args))
+		{
+			print_format("\033[0;91mThe recorded fractal is not valid\n"
+				"\033[0;39m");
+			return (1);
+		}
+		return (replay(&vars, &session, argc == 4));
+	}
+	record = NULL;
+	if (argc >= 4 && str_compare_all(argv[1], "record"))
+	{
+		record = argv[2];
+		argc -= 2;
+		argv += 2;
+	}
+	if (!valid_fractal(argc, argv))
+	{
+		print_usage();
 		exit(0);
 	}
-	initial_conditions(&vars, argv);
+	if (initial_conditions(&vars, argv))
+		exit(1);
+	session_init(&session);
+	if (record && session_record(&session, record, argc - 1, argv + 1))
+		exit(1);
+	vars.session = &session;
 	init_window(&vars);
 	sdl_loop(&vars);
 }
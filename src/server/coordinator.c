@@ -0,0 +1,427 @@
+/**
+ * @file coordinator.c
+ * @brief Coordinator of distributed poster renders
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Releases a worker connection and puts its task back in the pool
+ *
+ * @details A task whose only copy ran on the dropped worker becomes pending
+ * again and is re-issued to the next idle worker.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] coord Coordinator owning the worker
+ * @param[in,out] peer Worker that failed or disconnected
+ */
+static void	drop_peer(t_coordinator *coord, t_dist_peer *peer)
+{
+	if (peer->task >= 0 && !coord->tiles[peer->task].done)
+	{
+		coord->tiles[peer->task].copies--;
+		coord->failed++;
+	}
+	close(peer->fd);
+	peer->fd = -1;
+	peer->task = -1;
+}
+
+/**
+ * @brief Picks the next task for an idle worker
+ *
+ * @details Pending tasks come first. Once none is left, a task running on a
+ * single worker for more than twice the average task time (and at least
+ * DIST_BACKUP_MS) gets a backup copy, so a slow or stalled worker cannot hold
+ * the whole render; whichever copy finishes first is kept.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] coord Coordinator holding the tasks
+ *
+ * @return int Index of the task to send, or -1 if none should be sent
+ */
+static int	next_task(t_coordinator *coord)
+{
+	Uint32	limit;
+	Uint32	now;
+	int		best;
+	int		i;
+
+	i = -1;
+	while (++i < coord->ntiles)
+		if (!coord->tiles[i].done && !coord->tiles[i].copies)
+			return (i);
+	now = SDL_GetTicks();
+	limit = DIST_BACKUP_MS;
+	if (coord->finished && coord->task_ms * 2 / coord->finished > limit)
+		limit = coord->task_ms * 2 / coord->finished;
+	best = -1;
+	i = -1;
+	while (++i < coord->ntiles)
+		if (!coord->tiles[i].done && coord->tiles[i].copies == 1
+			&& now - coord->tiles[i].started > limit
+			&& (best < 0 || coord->tiles[i].started < coord->tiles[best].started))
+			best = i;
+	if (best >= 0)
+		coord->reissued++;
+	return (best);
+}
+
+/**
+ * @brief Hands a task to every idle worker
+ *
+ * @ingroup server
+ *
+ * @param[in,out] coord Coordinator holding the tasks and workers
+ */
+static void	assign_tasks(t_coordinator *coord)
+{
+	t_dist_peer	*peer;
+	int			i;
+
+	i = -1;
+	while (++i < DIST_MAX_WORKERS)
+	{
+		peer = &coord->peers[i];
+		if (peer->fd < 0 || peer->task >= 0
+			|| peer->greeted < (int)sizeof(peer->magic))
+			continue ;
+		peer->task = next_task(coord);
+		if (peer->task < 0)
+			return ;
+		coord->job.id = peer->task;
+		coord->job.area = coord->tiles[peer->task].area;
+		if (!coord->tiles[peer->task].copies++)
+			coord->tiles[peer->task].started = SDL_GetTicks();
+		if (net_send_all(peer->fd, &coord->job, sizeof(t_dist_task)))
+			drop_peer(coord, peer);
+	}
+}
+
+/**
+ * @brief Receives a result from a worker and shades it into the poster
+ *
+ * @details Results of tasks already completed by another copy are read and
+ * discarded. Escape counts are coloured with the regular colour schemes.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] coord Coordinator owning the poster
+ * @param[in,out] peer Worker with a pending result
+ */
+static void	receive_result(t_coordinator *coord, t_dist_peer *peer)
+{
+	t_dist_result	result;
+	t_dist_tile		*tile;
+	int				*counts;
+	int				i;
+
+	tile = &coord->tiles[peer->task];
+	counts = coord->counts;
+	if (net_recv_all(peer->fd, &result, sizeof(result))
+		|| result.id != (Uint32)peer->task || result.w != tile->area.w
+		|| result.h != tile->area.h
+		|| net_recv_all(peer->fd, counts, (size_t)result.w * result.h
+			* sizeof(int)))
+	{
+		drop_peer(coord, peer);
+		return ;
+	}
+	peer->task = -1;
+	peer->completed++;
+	tile->copies--;
+	if (tile->done)
+		return ;
+	tile->done = 1;
+	coord->finished++;
+	coord->task_ms += SDL_GetTicks() - tile->started;
+	i = -1;
+	while (++i < result.w * result.h)
+		put_le32(coord->image + BMP_HEADER_SIZE + ((size_t)(tile->area.y
+					+ i / result.w) * coord->job.width + tile->area.x
+				+ i % result.w) * 4, fractal_shade(&coord->data, counts[i]));
+}
+
+/**
+ * @brief Accepts a connection whose greeting is still to come
+ *
+ * @details Receives time out after DIST_TIMEOUT_MS, so a worker that stops
+ * mid-result is dropped and its task re-issued instead of blocking the
+ * coordinator. The greeting itself is read by read_greeting() once poll
+ * reports it, so connecting sockets never block the event loop.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] coord Coordinator accepting the worker
+ */
+static void	accept_worker(t_coordinator *coord)
+{
+	struct timeval	timeout;
+	int				fd;
+	int				i;
+
+	fd = accept(coord->listen_fd, NULL, NULL);
+	if (fd < 0)
+		return ;
+	timeout.tv_sec = DIST_TIMEOUT_MS / 1000;
+	timeout.tv_usec = DIST_TIMEOUT_MS % 1000 * 1000;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	i = 0;
+	while (i < DIST_MAX_WORKERS && coord->peers[i].fd >= 0)
+		i++;
+	if (i == DIST_MAX_WORKERS)
+	{
+		close(fd);
+		return ;
+	}
+	coord->peers[i].fd = fd;
+	coord->peers[i].task = -1;
+	coord->peers[i].completed = 0;
+	coord->peers[i].greeted = 0;
+	coord->peers[i].since = SDL_GetTicks();
+}
+
+/**
+ * @brief Reads the available bytes of a worker greeting
+ *
+ * @details Takes only what has arrived, without waiting. Once the whole
+ * DIST_MAGIC is in, the worker gets tasks; a wrong greeting or a closed
+ * connection frees the slot.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] coord Coordinator owning the worker
+ * @param[in,out] peer Connection with greeting bytes pending
+ */
+static void	read_greeting(t_coordinator *coord, t_dist_peer *peer)
+{
+	ssize_t	got;
+
+	got = recv(peer->fd, (Uint8 *)&peer->magic + peer->greeted,
+			sizeof(peer->magic) - peer->greeted, MSG_DONTWAIT);
+	if (got <= 0)
+	{
+		drop_peer(coord, peer);
+		return ;
+	}
+	peer->greeted += got;
+	if (peer->greeted < (int)sizeof(peer->magic))
+		return ;
+	if (peer->magic != DIST_MAGIC)
+	{
+		drop_peer(coord, peer);
+		return ;
+	}
+	coord->workers++;
+}
+
+/**
+ * @brief Closes the connections whose greeting is overdue
+ *
+ * @details Connections that have not sent their whole greeting
+ * DIST_TIMEOUT_MS after being accepted, such as port scans, are dropped.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] coord Coordinator owning the connections
+ */
+static void	drop_silent(t_coordinator *coord)
+{
+	t_dist_peer	*peer;
+	int			i;
+
+	i = -1;
+	while (++i < DIST_MAX_WORKERS)
+	{
+		peer = &coord->peers[i];
+		if (peer->fd >= 0 && peer->greeted < (int)sizeof(peer->magic)
+			&& SDL_GetTicks() - peer->since >= DIST_TIMEOUT_MS)
+			drop_peer(coord, peer);
+	}
+}
+
+/**
+ * @brief Runs the coordinator event loop until every task is done
+ *
+ * @details Alternates between handing out tasks and polling the listening
+ * socket, the busy workers and the connections still greeting. The poll
+ * times out regularly so backup copies of slow tasks are issued even while
+ * no worker reports back, and silent connections are dropped.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] coord Coordinator with its tasks split
+ */
+static void	coordinate(t_coordinator *coord)
+{
+	struct pollfd	fds[DIST_MAX_WORKERS + 1];
+	int				peer[DIST_MAX_WORKERS + 1];
+	int				n;
+	int				i;
+
+	while (coord->finished < coord->ntiles)
+	{
+		drop_silent(coord);
+		assign_tasks(coord);
+		fds[0] = (struct pollfd){coord->listen_fd, POLLIN, 0};
+		n = 1;
+		i = -1;
+		while (++i < DIST_MAX_WORKERS)
+		{
+			if (coord->peers[i].fd < 0 || (coord->peers[i].task < 0
+					&& coord->peers[i].greeted == (int)sizeof(Uint32)))
+				continue ;
+			peer[n] = i;
+			fds[n++] = (struct pollfd){coord->peers[i].fd, POLLIN, 0};
+		}
+		if (poll(fds, n, DIST_BACKUP_MS / 4) <= 0)
+			continue ;
+		i = 0;
+		while (++i < n)
+		{
+			if (!fds[i].revents)
+				continue ;
+			if (coord->peers[peer[i]].task < 0)
+				read_greeting(coord, &coord->peers[peer[i]]);
+			else
+				receive_result(coord, &coord->peers[peer[i]]);
+		}
+		if (fds[0].revents)
+			accept_worker(coord);
+	}
+}
+
+/**
+ * @brief Splits the poster into tasks and allocates the image
+ *
+ * @ingroup server
+ *
+ * @param[in,out] coord Coordinator with the job description filled in
+ *
+ * @return int Status of the operation
+ * @retval 0 Tasks and image ready
+ * @retval 1 Memory allocation failed
+ */
+static int	split_tasks(t_coordinator *coord)
+{
+	int	cols;
+	int	i;
+
+	cols = (coord->job.width + DIST_TILE_PX - 1) / DIST_TILE_PX;
+	coord->ntiles = cols * ((coord->job.height + DIST_TILE_PX - 1)
+			/ DIST_TILE_PX);
+	coord->tiles = (t_dist_tile *)calloc(coord->ntiles, sizeof(t_dist_tile));
+	coord->counts = (int *)malloc(DIST_TILE_PX * DIST_TILE_PX * sizeof(int));
+	coord->image = (Uint8 *)malloc(BMP_HEADER_SIZE
+			+ (size_t)coord->job.width * coord->job.height * 4);
+	if (!coord->tiles || !coord->counts || !coord->image)
+		return (1);
+	i = -1;
+	while (++i < coord->ntiles)
+	{
+		coord->tiles[i].area.x = i % cols * DIST_TILE_PX;
+		coord->tiles[i].area.y = i / cols * DIST_TILE_PX;
+		coord->tiles[i].area.w = fmin(DIST_TILE_PX,
+				coord->job.width - coord->tiles[i].area.x);
+		coord->tiles[i].area.h = fmin(DIST_TILE_PX,
+				coord->job.height - coord->tiles[i].area.y);
+	}
+	i = -1;
+	while (++i < DIST_MAX_WORKERS)
+		coord->peers[i].fd = -1;
+	return (0);
+}
+
+/**
+ * @brief Writes the finished poster and reports the run
+ *
+ * @ingroup server
+ *
+ * @param[in] coord Coordinator with every task done
+ * @param[in] path Output BMP file
+ * @param[in] start Tick at which the render started
+ *
+ * @return int Status of the operation
+ * @retval 0 Poster written
+ * @retval 1 The file could not be written
+ */
+static int	write_poster(t_coordinator *coord, const char *path, Uint32 start)
+{
+	char	line[160];
+	size_t	size;
+	int		fd;
+	int		status;
+
+	size = bmp_header(coord->image, coord->job.width, coord->job.height);
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	status = fd < 0 || write(fd, coord->image, size) != (ssize_t)size;
+	if (fd >= 0)
+		close(fd);
+	if (status)
+	{
+		print_format("\033[0;91mCannot write %s\n\033[0;39m", path);
+		return (1);
+	}
+	snprintf(line, sizeof(line), "%d tiles by %d workers in %.2fs (%.1f "
+		"Mpixel/s), %d re-issued, %d failed", coord->ntiles, coord->workers,
+		(SDL_GetTicks() - start) / 1000.0, (double)coord->job.width
+		* coord->job.height / 1000.0 / fmax(SDL_GetTicks() - start, 1),
+		coord->reissued, coord->failed);
+	print_format("\033[0;92mSaved %s: %s\n\033[0;39m", path, line);
+	return (0);
+}
+
+/**
+ * @brief Renders a poster on remote worker processes
+ *
+ * @details "./fractol coordinate <address> <out.bmp> <width> <height>
+ * <center_re> <center_im> <span> <fractal> [re im]" listens for workers
+ * started with "./fractol worker <address>", on this or other hosts, and
+ * splits the poster into DIST_TILE_PX squares handed out one per worker at a
+ * time, so faster workers naturally take more tiles. Failed workers have
+ * their task re-issued and slow ones get a backup copy. The iteration cap is
+ * the one the interactive view would use for the same span.
+ *
+ * @ingroup server
+ *
+ * @param[in] argc Number of command-line arguments
+ * @param[in] argv Command-line arguments, argv[1] being "coordinate"
+ *
+ * @return int Exit status of the render
+ */
+int	dist_coordinator(int argc, char **argv)
+{
+	static t_coordinator	coord;
+	Uint32					start;
+
+	if (argc < 10 || (!is_mandelbrot(argv[9]) && !is_julia(argv[9]))
+		|| argc != 10 + 2 * is_julia(argv[9]))
+	{
+		print_format("\033[0;91mUsage: coordinate address out.bmp width height"
+			" center_re center_im span fractal [re im]\n\033[0;39m");
+		return (1);
+	}
+	fractal_setup(&coord.data, argv + 9);
+	coord.job = (t_dist_task){DIST_MAGIC, 0, coord.data.type,
+		coord.data.initial_z, {str_to_float(argv[6]), str_to_float(argv[7])},
+		str_to_float(argv[8]), 0, str_to_int(argv[4]), str_to_int(argv[5]),
+		(SDL_Rect){0, 0, 0, 0}};
+	if (fractal_formula(coord.job.type)->julia)
+		coord.job.param = coord.data.initial_c;
+	coord.data.zoom_factor = 1.5 / coord.job.span;
+	coord.data.iter_factor = log2(coord.data.zoom_factor + 1);
+	coord.job.iter_factor = coord.data.iter_factor;
+	coord.listen_fd = net_listen(argv[2]);
+	if (coord.job.width <= 0 || coord.job.height <= 0 || coord.job.span <= 0
+		|| coord.listen_fd < 0 || split_tasks(&coord))
+		return (1);
+	print_format("\033[0;92mWaiting for workers on %s\n\033[0;39m", argv[2]);
+	start = SDL_GetTicks();
+	coordinate(&coord);
+	return (write_poster(&coord, argv[3], start));
+}
@@ -0,0 +1,182 @@
+/**
+ * @file net.c
+ * @brief TCP and Unix domain socket helpers for the server modes
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Fills a TCP socket address from "host:port" or "port"
+ *
+ * @details A bare port binds to the loopback interface only, so a server
+ * started without an explicit host is not reachable from other machines.
+ *
+ * @ingroup server
+ *
+ * @param[in] spec Address text following the "tcp:" prefix
+ * @param[out] addr Socket address to fill in
+ *
+ * @return int Status of the operation
+ * @retval 0 Address parsed
+ * @retval 1 Malformed host or port
+ */
+static int	tcp_address(const char *spec, struct sockaddr_in *addr)
+{
+	char		host[64];
+	const char	*port;
+
+	memset(addr, 0, sizeof(struct sockaddr_in));
+	addr->sin_family = AF_INET;
+	port = str_search_rev_char(spec, ':');
+	snprintf(host, sizeof(host), "127.0.0.1");
+	if (port && (size_t)(port - spec) < sizeof(host))
+		snprintf(host, port - spec + 1, "%s", spec);
+	if (port)
+		spec = port + 1;
+	addr->sin_port = htons((unsigned short)str_to_int(spec));
+	return (!addr->sin_port || inet_pton(AF_INET, host, &addr->sin_addr) != 1);
+}
+
+/**
+ * @brief Opens a stream socket for a "tcp:..." or "unix:..." address
+ *
+ * @details Binds and listens when listening is requested, connects
+ * otherwise. Unix socket paths left behind by a previous server are
+ * removed before binding.
+ *
+ * @ingroup server
+ *
+ * @param[in] address "tcp:[host:]port" or "unix:path"
+ * @param[in] listening Whether to listen (1) or connect (0)
+ *
+ * @return int Socket descriptor, or -1 on failure (message printed)
+ */
+static int	net_open(const char *address, int listening)
+{
+	struct sockaddr_in	tcp;
+	struct sockaddr_un	local;
+	struct sockaddr		*addr;
+	socklen_t			len;
+	int					fd;
+
+	fd = -1;
+	if (str_compare_n(address, "tcp:", 4) && !tcp_address(address + 4, &tcp))
+	{
+		addr = (struct sockaddr *)&tcp;
+		len = sizeof(tcp);
+		fd = socket(AF_INET, SOCK_STREAM, 0);
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &(int){1}, sizeof(int));
+	}
+	else if (str_compare_n(address, "unix:", 5)
+		&& str_len(address + 5) < sizeof(local.sun_path))
+	{
+		memset(&local, 0, sizeof(local));
+		local.sun_family = AF_UNIX;
+		str_copy(local.sun_path, address + 5, sizeof(local.sun_path));
+		addr = (struct sockaddr *)&local;
+		len = sizeof(local);
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listening)
+			unlink(local.sun_path);
+	}
+	if (fd >= 0 && ((listening && (bind(fd, addr, len) < 0
+					|| listen(fd, SOMAXCONN) < 0))
+			|| (!listening && connect(fd, addr, len) < 0)))
+	{
+		close(fd);
+		fd = -1;
+	}
+	if (fd < 0)
+		print_format("\033[0;91mCannot open %s\n\033[0;39m", address);
+	return (fd);
+}
+
+/**
+ * @brief Listens on a "tcp:[host:]port" or "unix:path" address
+ *
+ * @ingroup server
+ *
+ * @param[in] address Address to listen on
+ *
+ * @return int Listening socket descriptor, or -1 on failure
+ */
+int	net_listen(const char *address)
+{
+	return (net_open(address, 1));
+}
+
+/**
+ * @brief Sends a whole buffer, retrying short writes
+ *
+ * @details Never raises SIGPIPE: a peer that went away is reported as an
+ * error instead.
+ *
+ * @ingroup server
+ *
+ * @param[in] fd Connected socket
+ * @param[in] buffer Bytes to send
+ * @param[in] len Number of bytes to send
+ *
+ * @return int Status of the operation
+ * @retval 0 Every byte was sent
+ * @retval 1 The connection failed or timed out
+ */
+int	net_send_all(int fd, const void *buffer, size_t len)
+{
+	ssize_t	sent;
+
+	while (len > 0)
+	{
+		sent = send(fd, buffer, len, MSG_NOSIGNAL);
+		if (sent <= 0)
+			return (1);
+		buffer = (const char *)buffer + sent;
+		len -= sent;
+	}
+	return (0);
+}
+
+/**
+ * @brief Connects to a "tcp:host:port" or "unix:path" address
+ *
+ * @ingroup server
+ *
+ * @param[in] address Address to connect to
+ *
+ * @return int Connected socket descriptor, or -1 on failure
+ */
+int	net_connect(const char *address)
+{
+	return (net_open(address, 0));
+}
+
+/**
+ * @brief Receives exactly len bytes, retrying short reads
+ *
+ * @ingroup server
+ *
+ * @param[in] fd Connected socket
+ * @param[out] buffer Destination of the bytes
+ * @param[in] len Number of bytes to receive
+ *
+ * @return int Status of the operation
+ * @retval 0 Every byte was received
+ * @retval 1 The peer closed the connection, failed or timed out
+ */
+int	net_recv_all(int fd, void *buffer, size_t len)
+{
+	ssize_t	got;
+
+	while (len > 0)
+	{
+		got = recv(fd, buffer, len, 0);
+		if (got <= 0)
+			return (1);
+		buffer = (char *)buffer + got;
+		len -= got;
+	}
+	return (0);
+}
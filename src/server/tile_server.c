@@ -0,0 +1,637 @@
+/**
+ * @file tile_server.c
+ * @brief Slippy-map tile server answering HTTP requests over a socket
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Parses the path of a tile request into a job address
+ *
+ * @details Accepts "GET /<fractal>/<z>/<x>/<y>.bmp", with the two Julia
+ * constant components inserted after the name for Julia sets, as in
+ * "GET /julia/-0.8/0.156/<z>/<x>/<y>.bmp". The fractal names are the ones of
+ * the command line. Tile (0, 0) of zoom z is the top-left one, and zoom 0 is
+ * a single tile covering the TILE_ROOT_SPAN square centred on the origin.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] request NUL-terminated request text, modified in place
+ * @param[out] job Job receiving the tile address
+ *
+ * @return int Status of the request
+ * @retval 0 Valid tile request
+ * @retval 400 Malformed request or tile address
+ * @retval 404 Unknown fractal or tile outside the zoom level
+ */
+static int	parse_request(char *request, t_tile_job *job)
+{
+	char	*args[6];
+	char	*token;
+	char	*save;
+	char	*end;
+	long	level;
+	int		n;
+
+	if (!str_compare_n(request, "GET /", 5)
+		|| !str_search_char(request + 4, ' '))
+		return (400);
+	*str_search_char(request + 4, ' ') = '\0';
+	n = 0;
+	token = strtok_r(request + 4, "/", &save);
+	while (token && n < 6)
+	{
+		args[n++] = token;
+		token = strtok_r(NULL, "/", &save);
+	}
+	if (token || n < 4 || (!is_mandelbrot(args[0]) && !is_julia(args[0]))
+		|| n != 4 + 2 * is_julia(args[0]))
+		return (404);
+	memset(&job->data, 0, sizeof(t_data));
+	fractal_setup(&job->data, args);
+	job->key.type = job->data.type;
+	job->key.param = job->data.initial_z;
+	if (fractal_formula(job->key.type)->julia)
+		job->key.param = job->data.initial_c;
+	level = strtol(args[n - 3], &end, 10);
+	if (end == args[n - 3] || *end)
+		return (400);
+	job->key.tx = strtol(args[n - 2], &end, 10);
+	if (end == args[n - 2] || *end)
+		return (400);
+	job->key.ty = strtol(args[n - 1], &end, 10);
+	if (end == args[n - 1] || !str_compare_all(end, ".bmp"))
+		return (400);
+	if (level < 0 || level > SERVER_MAX_ZOOM)
+		return (404);
+	job->key.level = level;
+	if (job->key.tx < 0 || job->key.tx >= 1L << job->key.level
+		|| job->key.ty < 0 || job->key.ty >= 1L << job->key.level)
+		return (404);
+	return (0);
+}
+
+/**
+ * @brief Reads a cache tile from the persistent store
+ *
+ * @details The samples are copied out under the store lock, since another
+ * worker may reuse the slot as soon as it is released.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server owning the store
+ * @param[in] key Address of the cache tile
+ * @param[out] out TILE_SIZE² escape counts, row-major
+ *
+ * @return int 1 if the tile was stored, 0 if it must be computed
+ */
+static int	store_load(t_server *server, const t_tile_key *key, int *out)
+{
+	int	slot;
+
+	pthread_mutex_lock(&server->store_lock);
+	slot = tile_store_find(&server->store, key);
+	if (slot >= 0)
+		mem_copy(out, tile_store_samples(&server->store, slot),
+			TILE_SIZE * TILE_SIZE * sizeof(int));
+	pthread_mutex_unlock(&server->store_lock);
+	return (slot >= 0);
+}
+
+/**
+ * @brief Writes a computed cache tile to the persistent store
+ *
+ * @details The tile is computed outside the lock and only copied into its
+ * slot here, which is published at once. A busy set simply drops it.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server owning the store
+ * @param[in] key Address of the cache tile
+ * @param[in] samples TILE_SIZE² escape counts, row-major
+ */
+static void	store_save(t_server *server, const t_tile_key *key,
+				const int *samples)
+{
+	int	slot;
+
+	pthread_mutex_lock(&server->store_lock);
+	slot = tile_store_reserve(&server->store, key);
+	if (slot >= 0)
+	{
+		mem_copy(tile_store_samples(&server->store, slot), samples,
+			TILE_SIZE * TILE_SIZE * sizeof(int));
+		tile_store_commit(&server->store, slot);
+	}
+	pthread_mutex_unlock(&server->store_lock);
+}
+
+/**
+ * @brief Gathers the samples of a served tile from cache tiles
+ *
+ * @details A served tile is a square of SERVER_TILE_PX / TILE_SIZE cache
+ * tiles per side, addressed exactly as the interactive tile cache
+ * addresses them. Each one is read from the persistent store when an
+ * earlier run, served tile or tile mode export left it there, and computed
+ * with tile_samples() and stored otherwise.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server owning the store
+ * @param[in] job Job with the fractal parameters and iteration cap
+ * @param[in] level Cache level of the served zoom
+ * @param[in] origin Global sample indices of the first column and row
+ * @param[out] samples SERVER_TILE_PX² escape counts, row-major
+ */
+static void	job_samples(t_server *server, t_tile_job *job, int level,
+				const long *origin, int *samples)
+{
+	int			tile[TILE_SIZE * TILE_SIZE];
+	long		corner[2];
+	t_tile_key	key;
+	int			i;
+	int			y;
+
+	key = job->key;
+	key.tier = tile_key_tier(&job->data);
+	key.variant = job->data.step.hash ^ (job->data.start.hash * 16777619u);
+	key.level = level;
+	pthread_mutex_lock(&server->store_lock);
+	tile_store_tick(&server->store);
+	pthread_mutex_unlock(&server->store_lock);
+	i = -1;
+	while (++i < SERVER_TILE_PX / TILE_SIZE * (SERVER_TILE_PX / TILE_SIZE))
+	{
+		key.tx = origin[0] / TILE_SIZE + i % (SERVER_TILE_PX / TILE_SIZE);
+		key.ty = origin[1] / TILE_SIZE + i / (SERVER_TILE_PX / TILE_SIZE);
+		corner[0] = key.tx * TILE_SIZE;
+		corner[1] = key.ty * TILE_SIZE;
+		if (!store_load(server, &key, tile))
+		{
+			tile_samples(&job->data, level, corner, TILE_SIZE, tile);
+			store_save(server, &key, tile);
+		}
+		y = -1;
+		while (++y < TILE_SIZE)
+			mem_copy(samples + (corner[1] - origin[1] + y) * SERVER_TILE_PX
+				+ corner[0] - origin[0], tile + y * TILE_SIZE,
+				TILE_SIZE * sizeof(int));
+	}
+}
+
+/**
+ * @brief Renders the tile of a job as a BMP image
+ *
+ * @details The tile is SERVER_TILE_PX square and covers 2^-z of the zoom 0
+ * square on each axis. Its samples come from the cache tiles of the level
+ * of matching spacing, with the iteration cap of that level, so the server
+ * shows exactly what the interactive tile cache shows and shares its
+ * persistent store. The image is a top-down 32-bit BMP, see bmp_header().
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server owning the persistent store
+ * @param[in,out] job Job to render; body is left NULL on allocation failure
+ */
+static void	render_job(t_server *server, t_tile_job *job)
+{
+	int		*samples;
+	long	origin[2];
+	int		level;
+	int		i;
+
+	level = job->key.level + SERVER_LEVEL_SHIFT;
+	job->data.zoom_factor = 1.0;
+	job->data.iter_factor = tile_level_factor(level);
+	origin[0] = job->key.tx * SERVER_TILE_PX
+		- (SERVER_TILE_PX / 2L << job->key.level);
+	origin[1] = job->key.ty * SERVER_TILE_PX
+		- (SERVER_TILE_PX / 2L << job->key.level);
+	samples = (int *)malloc(SERVER_TILE_PX * SERVER_TILE_PX * sizeof(int));
+	job->body = (Uint8 *)malloc(BMP_HEADER_SIZE
+			+ SERVER_TILE_PX * SERVER_TILE_PX * 4);
+	if (samples && job->body)
+	{
+		job_samples(server, job, level, origin, samples);
+		job->body_len = bmp_header(job->body, SERVER_TILE_PX, SERVER_TILE_PX);
+		i = -1;
+		while (++i < SERVER_TILE_PX * SERVER_TILE_PX)
+			put_le32(job->body + BMP_HEADER_SIZE + i * 4,
+				fractal_shade(&job->data, samples[i]));
+	}
+	else
+	{
+		free(job->body);
+		job->body = NULL;
+	}
+	free(samples);
+}
+
+/**
+ * @brief Worker thread rendering queued tile jobs
+ *
+ * @details Takes jobs from the shared queue, renders them without holding
+ * the lock and moves them to the done list, waking the event loop through
+ * its pipe. All clients waiting for a tile share the single render.
+ *
+ * @ingroup server
+ *
+ * @param[in] arg Pointer to the t_server instance
+ *
+ * @return void* Always returns NULL (required by pthread interface)
+ */
+static void	*server_worker(void *arg)
+{
+	t_server	*server;
+	t_tile_job	*job;
+
+	server = (t_server *)arg;
+	while (1)
+	{
+		pthread_mutex_lock(&server->lock);
+		while (!server->queue)
+			pthread_cond_wait(&server->ready, &server->lock);
+		job = server->queue;
+		server->queue = job->queue_next;
+		pthread_mutex_unlock(&server->lock);
+		render_job(server, job);
+		pthread_mutex_lock(&server->lock);
+		job->queue_next = server->done;
+		server->done = job;
+		pthread_mutex_unlock(&server->lock);
+		if (write(server->wake[1], "", 1) < 0)
+			continue ;
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Sends a bodyless HTTP error response and closes the connection
+ *
+ * @ingroup server
+ *
+ * @param[in] fd Client socket
+ * @param[in] status HTTP status code (400, 404, 408, 500 or 503)
+ */
+static void	reply_error(int fd, int status)
+{
+	char		head[128];
+	const char	*reason;
+	int			len;
+
+	reason = "Internal Server Error";
+	if (status == 400)
+		reason = "Bad Request";
+	else if (status == 404)
+		reason = "Not Found";
+	else if (status == 408)
+		reason = "Request Timeout";
+	else if (status == 503)
+		reason = "Service Unavailable";
+	len = snprintf(head, sizeof(head), "HTTP/1.0 %d %s\r\nContent-Length: 0"
+			"\r\nConnection: close\r\n\r\n", status, reason);
+	net_send_all(fd, head, len);
+	close(fd);
+}
+
+/**
+ * @brief Answers every client waiting for a finished job
+ *
+ * @details Called from the event loop only, which owns the in-flight list,
+ * so clients merged into the job while it rendered are answered too. The
+ * X-Tile-Clients header tells how many requests the render served.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server owning the job
+ * @param[in] job Finished job, unlinked from the in-flight list and freed
+ */
+static void	finish_job(t_server *server, t_tile_job *job)
+{
+	t_tile_job	**link;
+	char		head[256];
+	int			len;
+	int			i;
+
+	link = &server->inflight;
+	while (*link != job)
+		link = &(*link)->next;
+	*link = job->next;
+	len = snprintf(head, sizeof(head), "HTTP/1.0 200 OK\r\nContent-Type: "
+			"image/bmp\r\nContent-Length: %zu\r\nX-Tile-Clients: %d\r\n"
+			"Access-Control-Allow-Origin: *\r\nConnection: close\r\n\r\n",
+			job->body_len, job->nclients);
+	i = -1;
+	while (++i < job->nclients)
+	{
+		if (!job->body)
+		{
+			reply_error(job->clients[i], 500);
+			continue ;
+		}
+		if (!net_send_all(job->clients[i], head, len))
+			net_send_all(job->clients[i], job->body, job->body_len);
+		close(job->clients[i]);
+	}
+	server->rendered++;
+	server->served += job->nclients;
+	free(job->clients);
+	free(job->body);
+	free(job);
+}
+
+/**
+ * @brief Attaches a client to the job rendering its tile
+ *
+ * @details A request for a tile already queued or rendering joins that job
+ * instead of starting another render. Otherwise a new job is pushed on the
+ * worker queue, which is served newest first: a map viewer requests the
+ * tiles of the view being looked at last, after those it scrolled past.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server receiving the request
+ * @param[in] request Parsed job address; copied when a new job is needed
+ * @param[in] fd Client socket waiting for the tile
+ */
+static void	dispatch(t_server *server, t_tile_job *request, int fd)
+{
+	t_tile_job	*job;
+	int			*clients;
+
+	job = server->inflight;
+	while (job && !tile_key_equal(&job->key, &request->key))
+		job = job->next;
+	if (!job)
+	{
+		job = (t_tile_job *)malloc(sizeof(t_tile_job));
+		if (!job)
+		{
+			reply_error(fd, 500);
+			return ;
+		}
+		*job = *request;
+		job->next = server->inflight;
+		server->inflight = job;
+		pthread_mutex_lock(&server->lock);
+		job->queue_next = server->queue;
+		server->queue = job;
+		pthread_cond_signal(&server->ready);
+		pthread_mutex_unlock(&server->lock);
+	}
+	clients = (int *)realloc(job->clients, (job->nclients + 1) * sizeof(int));
+	if (!clients)
+	{
+		reply_error(fd, 500);
+		return ;
+	}
+	job->clients = clients;
+	job->clients[job->nclients++] = fd;
+}
+
+/**
+ * @brief Reads request bytes from a client and dispatches complete requests
+ *
+ * @details Requests are small; once the blank line ending the HTTP header
+ * arrives, the client leaves the read set and waits for its tile. Clients
+ * that close early or send oversized headers are dropped.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server owning the client
+ * @param[in,out] client Connection with pending input
+ */
+static void	read_client(t_server *server, t_client *client)
+{
+	t_tile_job	request;
+	ssize_t		got;
+	int			status;
+
+	got = recv(client->fd, client->buf + client->len,
+			SERVER_REQUEST_MAX - 1 - client->len, 0);
+	if (got <= 0)
+	{
+		close(client->fd);
+		client->fd = -1;
+		return ;
+	}
+	client->len += got;
+	client->buf[client->len] = '\0';
+	if (!str_search_str(client->buf, "\r\n\r\n", client->len)
+		&& !str_search_str(client->buf, "\n\n", client->len))
+	{
+		if (client->len == SERVER_REQUEST_MAX - 1)
+			reply_error(client->fd, 400);
+		if (client->len == SERVER_REQUEST_MAX - 1)
+			client->fd = -1;
+		return ;
+	}
+	memset(&request, 0, sizeof(t_tile_job));
+	status = parse_request(client->buf, &request);
+	if (status)
+		reply_error(client->fd, status);
+	else
+		dispatch(server, &request, client->fd);
+	client->fd = -1;
+}
+
+/**
+ * @brief Accepts a connection into a free client slot
+ *
+ * @details Sends time out after SERVER_SEND_TIMEOUT_MS so a stalled client
+ * cannot hold the event loop. Connections beyond SERVER_MAX_CLIENTS are
+ * refused with 503, and the accept tick starts the read timeout of the
+ * request.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server accepting the connection
+ */
+static void	accept_client(t_server *server)
+{
+	struct timeval	timeout;
+	int				fd;
+	int				i;
+
+	fd = accept(server->listen_fd, NULL, NULL);
+	if (fd < 0)
+		return ;
+	timeout.tv_sec = SERVER_SEND_TIMEOUT_MS / 1000;
+	timeout.tv_usec = SERVER_SEND_TIMEOUT_MS % 1000 * 1000;
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+	i = -1;
+	while (++i < SERVER_MAX_CLIENTS && server->clients[i].fd >= 0)
+		;
+	if (i == SERVER_MAX_CLIENTS)
+	{
+		reply_error(fd, 503);
+		return ;
+	}
+	server->clients[i].fd = fd;
+	server->clients[i].len = 0;
+	server->clients[i].since = SDL_GetTicks();
+}
+
+/**
+ * @brief Closes the clients whose request header is overdue
+ *
+ * @details Clients still sending their request SERVER_READ_TIMEOUT_MS after
+ * being accepted are answered 408 and their slot is freed.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server owning the clients
+ *
+ * @return int Milliseconds until the next client is due, -1 if none reads
+ */
+static int	evict_stale(t_server *server)
+{
+	Uint32	age;
+	int		next;
+	int		i;
+
+	next = -1;
+	i = -1;
+	while (++i < SERVER_MAX_CLIENTS)
+	{
+		if (server->clients[i].fd < 0)
+			continue ;
+		age = SDL_GetTicks() - server->clients[i].since;
+		if (age >= SERVER_READ_TIMEOUT_MS)
+		{
+			reply_error(server->clients[i].fd, 408);
+			server->clients[i].fd = -1;
+		}
+		else if (next < 0 || (int)(SERVER_READ_TIMEOUT_MS - age) < next)
+			next = SERVER_READ_TIMEOUT_MS - age;
+	}
+	return (next);
+}
+
+/**
+ * @brief Answers the jobs finished by the workers since the last wake-up
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Server whose done list is drained
+ */
+static void	collect_done(t_server *server)
+{
+	t_tile_job	*done;
+	t_tile_job	*next;
+	char		drain[64];
+
+	while (read(server->wake[0], drain, sizeof(drain)) == sizeof(drain))
+		;
+	pthread_mutex_lock(&server->lock);
+	done = server->done;
+	server->done = NULL;
+	pthread_mutex_unlock(&server->lock);
+	while (done)
+	{
+		next = done->queue_next;
+		finish_job(server, done);
+		done = next;
+	}
+}
+
+/**
+ * @brief Runs one iteration of the server event loop
+ *
+ * @details Polls the listening socket, the wake-up pipe of the workers and
+ * every client still sending its request, then handles whatever is ready.
+ * Overdue clients are evicted first, and the poll wakes up when the next
+ * one falls due. All socket I/O happens on this thread; workers only
+ * render.
+ *
+ * @ingroup server
+ *
+ * @param[in,out] server Running server
+ */
+static void	server_poll(t_server *server)
+{
+	struct pollfd	fds[SERVER_MAX_CLIENTS + 2];
+	int				slot[SERVER_MAX_CLIENTS + 2];
+	int				timeout;
+	int				n;
+	int				i;
+
+	timeout = evict_stale(server);
+	fds[0] = (struct pollfd){server->listen_fd, POLLIN, 0};
+	fds[1] = (struct pollfd){server->wake[0], POLLIN, 0};
+	n = 2;
+	i = -1;
+	while (++i < SERVER_MAX_CLIENTS)
+	{
+		if (server->clients[i].fd < 0)
+			continue ;
+		slot[n] = i;
+		fds[n++] = (struct pollfd){server->clients[i].fd, POLLIN, 0};
+	}
+	if (poll(fds, n, timeout) <= 0)
+		return ;
+	if (fds[1].revents)
+		collect_done(server);
+	i = 1;
+	while (++i < n)
+		if (fds[i].revents)
+			read_client(server, &server->clients[slot[i]]);
+	if (fds[0].revents)
+		accept_client(server);
+}
+
+/**
+ * @brief Serves fractal tiles over HTTP until the process is terminated
+ *
+ * @details Listens on a "tcp:[host:]port" or "unix:path" address and
+ * answers GET requests for slippy-map tiles (see parse_request()) with BMP
+ * images rendered on demand by a pool of one worker per CPU. Concurrent
+ * requests for the same tile are merged into one render, and the tiles are
+ * kept in the persistent store at TILE_STORE_PATH, shared with the window's
+ * tile mode of later runs when no other process holds it; Sinh and Dragon
+ * tiles, which the window renders at the preview tier, are the exception
+ * (see tile_key_tier()). No window is opened, so the server runs
+ * headless; it can be tried entirely on localhost, e.g.
+ * curl http://127.0.0.1:8080/mandelbrot/2/1/1.bmp.
+ *
+ * @ingroup server
+ *
+ * @param[in] address Address to listen on
+ * @param[in] cpu Worker count and pinning of the pool
+ *
+ * @return int Exit status: 1 if the server could not start
+ */
+int	tile_server(const char *address, const t_cpu *cpu)
+{
+	static t_server	server;
+	pthread_attr_t	attr;
+	int				i;
+
+	server.listen_fd = net_listen(address);
+	if (server.listen_fd < 0 || pipe(server.wake) < 0)
+		return (1);
+	fcntl(server.wake[0], F_SETFL, O_NONBLOCK);
+	pthread_mutex_init(&server.lock, NULL);
+	pthread_cond_init(&server.ready, NULL);
+	pthread_mutex_init(&server.store_lock, NULL);
+	tile_store_open(&server.store, TILE_STORE_PATH);
+	i = -1;
+	while (++i < SERVER_MAX_CLIENTS)
+		server.clients[i].fd = -1;
+	server.nworkers = cpu->threads;
+	i = -1;
+	while (++i < server.nworkers)
+	{
+		cpu_thread_attr(cpu, &attr, i);
+		pthread_create(&server.workers[i], &attr, server_worker, &server);
+		pthread_attr_destroy(&attr);
+	}
+	print_format("\033[0;92mServing tiles on %s with %d workers\n\033[0;39m",
+		address, server.nworkers);
+	while (1)
+		server_poll(&server);
+	return (0);
+}
@@ -0,0 +1,148 @@
+/**
+ * @file worker.c
+ * @brief Render worker process of the distributed mode
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Maps a poster pixel to the complex plane
+ *
+ * @details Same transform as screen_to_complex() for a window of the poster
+ * size centred on the task centre, so a poster of the interactive window
+ * size and view matches the window pixel for pixel.
+ *
+ * @ingroup server
+ *
+ * @param[in] task Task describing the poster view
+ * @param[in] x Horizontal poster coordinate in pixels
+ * @param[in] y Vertical poster coordinate in pixels
+ *
+ * @return t_complex Complex plane point under the pixel
+ */
+static t_complex	poster_to_complex(const t_dist_task *task, int x, int y)
+{
+	t_complex	point;
+
+	point.real = ((double)x / task->width - 0.5) * task->span
+		+ task->center.real;
+	point.imag = ((double)y / task->height - 0.5) * task->span
+		* task->height / task->width + task->center.imag;
+	return (point);
+}
+
+/**
+ * @brief Computes the escape counts of one task
+ *
+ * @details Runs the regular escape kernels on every pixel of the task area,
+ * with the iteration cap fixed by the coordinator so that every worker uses
+ * the same one. Poster pixels do not lie on the sample grid of the tile
+ * cache, so the persistent tile store is not consulted; several worker
+ * processes on one host could not share its lock either.
+ *
+ * @ingroup server
+ *
+ * @param[in] task Task to compute
+ * @param[out] out area.w x area.h escape counts, row-major
+ */
+static void	compute_task(const t_dist_task *task, int *out)
+{
+	t_data	data;
+	int		x;
+	int		y;
+
+	memset(&data, 0, sizeof(t_data));
+	data.type = task->type;
+	data.initial_z = task->param;
+	data.initial_c = task->param;
+	data.zoom_factor = 1.0;
+	data.iter_factor = task->iter_factor;
+	y = -1;
+	while (++y < task->area.h)
+	{
+		x = -1;
+		while (++x < task->area.w)
+			out[y * task->area.w + x] = fractal_escape(&data,
+					poster_to_complex(task, task->area.x + x,
+						task->area.y + y));
+	}
+}
+
+/**
+ * @brief Serves tasks from a coordinator until it closes the connection
+ *
+ * @details Announces itself, then repeatedly receives a task, computes it and
+ * sends back a result header followed by the escape counts. The peers must
+ * run the same build, since structures travel in native layout.
+ *
+ * @ingroup server
+ *
+ * @param[in] address Address of the coordinator
+ *
+ * @return int Exit status: 0 once the coordinator is done, 1 on failure
+ */
+static int	worker_loop(const char *address)
+{
+	t_dist_task		task;
+	t_dist_result	result;
+	int				*out;
+	int				fd;
+
+	fd = net_connect(address);
+	if (fd < 0)
+		return (1);
+	result.magic = DIST_MAGIC;
+	out = NULL;
+	if (net_send_all(fd, &result.magic, sizeof(Uint32)))
+		return (1);
+	while (!net_recv_all(fd, &task, sizeof(t_dist_task))
+		&& task.magic == DIST_MAGIC)
+	{
+		free(out);
+		out = (int *)malloc((size_t)task.area.w * task.area.h * sizeof(int));
+		if (!out)
+			break ;
+		compute_task(&task, out);
+		result.id = task.id;
+		result.w = task.area.w;
+		result.h = task.area.h;
+		if (net_send_all(fd, &result, sizeof(t_dist_result))
+			|| net_send_all(fd, out, (size_t)task.area.w * task.area.h
+				* sizeof(int)))
+			break ;
+	}
+	free(out);
+	close(fd);
+	return (0);
+}
+
+/**
+ * @brief Starts one or more render worker processes
+ *
+ * @details "./fractol worker <address> [processes]" connects to a
+ * coordinator. Each process computes one task at a time, so one process per
+ * core is started on every host; the extra ones are forked here and share
+ * nothing but the coordinator.
+ *
+ * @ingroup server
+ *
+ * @param[in] address Address of the coordinator
+ * @param[in] processes Number of worker processes to run on this host
+ *
+ * @return int Exit status of the worker
+ */
+int	dist_worker(const char *address, int processes)
+{
+	int	status;
+
+	while (--processes > 0)
+		if (fork() == 0)
+			return (worker_loop(address));
+	status = worker_loop(address);
+	while (wait(NULL) > 0)
+		;
+	return (status);
+}
@@ -0,0 +1,361 @@
+/**
+ * @file tile_cache.c
+ * @brief LRU hash table of escape count tiles with a memory cap
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Hashes a tile address
+ *
+ * @details FNV-1a over the fields of the key. Doubles are hashed by their bit
+ * pattern, which is fine since keys are built the same way for every view.
+ * The hash does not depend on the process, so it can index the persistent
+ * store too.
+ *
+ * @ingroup tiles
+ *
+ * @param[in] key Tile address to hash
+ *
+ * @return Uint64 Hash of the key
+ */
+Uint64	tile_key_hash(const t_tile_key *key)
+{
+	Uint64	words[8];
+	Uint64	hash;
+	int		i;
+
+	words[0] = (Uint64)key->type;
+	memcpy(&words[1], &key->param.real, sizeof(Uint64));
+	memcpy(&words[2], &key->param.imag, sizeof(Uint64));
+	words[3] = (Uint64)key->tier;
+	words[4] = (Uint64)key->level;
+	words[5] = (Uint64)key->tx;
+	words[6] = (Uint64)key->ty;
+	words[7] = (Uint64)key->variant;
+	hash = 0xcbf29ce484222325ULL;
+	i = -1;
+	while (++i < 8)
+	{
+		hash ^= words[i];
+		hash *= 0x100000001b3ULL;
+		hash ^= hash >> 29;
+	}
+	return (hash);
+}
+
+/**
+ * @brief Returns the hash bucket of a tile address
+ *
+ * @ingroup tiles
+ *
+ * @param[in] key Tile address
+ *
+ * @return Uint32 Bucket index in the range [0, TILE_BUCKETS)
+ */
+static Uint32	tile_bucket(const t_tile_key *key)
+{
+	return ((Uint32)tile_key_hash(key) & (TILE_BUCKETS - 1));
+}
+
+/**
+ * @brief Compares two tile addresses field by field
+ *
+ * @ingroup tiles
+ *
+ * @param[in] a First tile address
+ * @param[in] b Second tile address
+ *
+ * @return int Boolean result of the comparison
+ * @retval 1 Both keys address the same tile
+ * @retval 0 The keys differ
+ */
+int	tile_key_equal(const t_tile_key *a, const t_tile_key *b)
+{
+	return (a->type == b->type && a->tier == b->tier && a->level == b->level
+		&& a->variant == b->variant && a->tx == b->tx && a->ty == b->ty
+		&& a->param.real == b->param.real && a->param.imag == b->param.imag);
+}
+
+/**
+ * @brief Moves a tile to the most recently used end of the list
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] cache Tile cache owning the list
+ * @param[in,out] tile Tile to move, already linked or freshly allocated
+ * @param[in] linked Whether the tile is currently in the list
+ */
+static void	tile_touch(t_tile_cache *cache, t_tile *tile, int linked)
+{
+	if (linked && cache->head == tile)
+		return ;
+	if (linked)
+	{
+		tile->prev->next = tile->next;
+		if (tile->next)
+			tile->next->prev = tile->prev;
+		else
+			cache->tail = tile->prev;
+	}
+	tile->prev = NULL;
+	tile->next = cache->head;
+	if (cache->head)
+		cache->head->prev = tile;
+	cache->head = tile;
+	if (!cache->tail)
+		cache->tail = tile;
+}
+
+/**
+ * @brief Returns the memory a cached tile holds
+ *
+ * @details Tiles backed by the persistent store only own their structure;
+ * their samples belong to the page cache.
+ *
+ * @ingroup tiles
+ *
+ * @param[in] tile Cached tile
+ *
+ * @return size_t Bytes counted against the memory cap
+ */
+static size_t	tile_bytes(const t_tile *tile)
+{
+	if (tile->slot >= 0)
+		return (sizeof(t_tile));
+	return (sizeof(t_tile) + TILE_SIZE * TILE_SIZE * sizeof(int));
+}
+
+/**
+ * @brief Initializes an empty, disabled tile cache
+ *
+ * @details No memory is allocated and no store is opened until the cache is
+ * first enabled, so the default interactive mode pays nothing for it.
+ *
+ * @ingroup tiles
+ *
+ * @param[out] cache Tile cache to initialize
+ * @param[in] limit Memory cap in bytes before tiles are evicted
+ */
+void	tile_cache_init(t_tile_cache *cache, size_t limit)
+{
+	memset(cache, 0, sizeof(t_tile_cache));
+	cache->limit = limit;
+	cache->store.fd_index = -1;
+	cache->store.fd_data = -1;
+}
+
+/**
+ * @brief Looks up a tile and marks it as used by the current frame
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] cache Tile cache to search
+ * @param[in] key Address of the tile
+ *
+ * @return t_tile* Cached tile, or NULL when it is not in the cache
+ */
+t_tile	*tile_cache_find(t_tile_cache *cache, const t_tile_key *key)
+{
+	t_tile	*tile;
+
+	tile = cache->buckets[tile_bucket(key)];
+	while (tile && !tile_key_equal(&tile->key, key))
+		tile = tile->chain;
+	if (!tile)
+		return (NULL);
+	tile->stamp = cache->frame;
+	tile_touch(cache, tile, 1);
+	return (tile);
+}
+
+/**
+ * @brief Takes a tile from the spare list of its kind, or allocates one
+ *
+ * @details Tiles evicted from the cache are kept on two spare lists, one
+ * of tiles carrying their own samples and one of store-backed tiles, and
+ * handed out again before the system allocator is called. Once the cache
+ * has reached its memory cap, every new tile replaces an evicted one, so
+ * browsing with the cache enabled makes no allocations.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] cache Tile cache holding the spare lists
+ * @param[in] slot Store slot holding the samples, or -1 for own samples
+ *
+ * @return t_tile* Unlinked tile, or NULL if allocation failed
+ */
+static t_tile	*tile_alloc(t_tile_cache *cache, int slot)
+{
+	t_tile	**spare;
+	t_tile	*tile;
+
+	spare = &cache->spare;
+	if (slot >= 0)
+		spare = &cache->spare_slots;
+	tile = *spare;
+	if (tile)
+	{
+		*spare = tile->chain;
+		return (tile);
+	}
+	if (slot >= 0)
+		return ((t_tile *)malloc(sizeof(t_tile)));
+	return ((t_tile *)malloc(sizeof(t_tile)
+			+ TILE_SIZE * TILE_SIZE * sizeof(int)));
+}
+
+/**
+ * @brief Allocates a tile and links it into the cache
+ *
+ * @details With a store slot, the tile uses the samples mapped from that
+ * slot in place; any other cached tile still using the slot, which the store
+ * has just given away, is dropped. Without one, the samples come with the
+ * tile and are left uninitialized for the caller to compute. No tile is
+ * evicted for memory here, so every tile of a frame stays valid until the
+ * frame is composed; see tile_cache_trim().
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] cache Tile cache receiving the tile
+ * @param[in] key Address of the new tile, not present in the cache
+ * @param[in] slot Store slot holding the samples, or -1 for heap samples
+ *
+ * @return t_tile* New tile, or NULL if allocation failed
+ */
+t_tile	*tile_cache_insert(t_tile_cache *cache, const t_tile_key *key, int slot)
+{
+	t_tile	*tile;
+	Uint32	bucket;
+
+	if (slot >= 0 && cache->owners[slot])
+		tile_cache_remove(cache, cache->owners[slot]);
+	tile = tile_alloc(cache, slot);
+	if (!tile)
+		return (NULL);
+	tile->key = *key;
+	tile->stamp = cache->frame;
+	tile->slot = slot;
+	tile->iters = (int *)(tile + 1);
+	if (slot >= 0)
+	{
+		tile->iters = tile_store_samples(&cache->store, slot);
+		cache->owners[slot] = tile;
+	}
+	bucket = tile_bucket(key);
+	tile->chain = cache->buckets[bucket];
+	cache->buckets[bucket] = tile;
+	tile_touch(cache, tile, 0);
+	cache->bytes += tile_bytes(tile);
+	return (tile);
+}
+
+/**
+ * @brief Unlinks a tile from the cache and keeps it for reuse
+ *
+ * @details The tile goes to the spare list of its kind, for the next
+ * insertion to take. Samples living in the store are left there for later
+ * runs.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] cache Tile cache holding the tile
+ * @param[in] tile Cached tile to remove
+ */
+void	tile_cache_remove(t_tile_cache *cache, t_tile *tile)
+{
+	t_tile	**link;
+
+	link = &cache->buckets[tile_bucket(&tile->key)];
+	while (*link != tile)
+		link = &(*link)->chain;
+	*link = tile->chain;
+	if (tile->prev)
+		tile->prev->next = tile->next;
+	else
+		cache->head = tile->next;
+	if (tile->next)
+		tile->next->prev = tile->prev;
+	else
+		cache->tail = tile->prev;
+	if (tile->slot >= 0)
+		cache->owners[tile->slot] = NULL;
+	cache->bytes -= tile_bytes(tile);
+	link = &cache->spare;
+	if (tile->slot >= 0)
+		link = &cache->spare_slots;
+	tile->chain = *link;
+	*link = tile;
+}
+
+/**
+ * @brief Evicts least recently used tiles until the memory cap is met
+ *
+ * @details Stops at the first tile used by the current frame: every tile
+ * behind it in the list was used by this frame too, so they must stay.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] cache Tile cache to trim
+ */
+void	tile_cache_trim(t_tile_cache *cache)
+{
+	while (cache->bytes > cache->limit && cache->tail
+		&& cache->tail->stamp != cache->frame)
+		tile_cache_remove(cache, cache->tail);
+}
+
+/**
+ * @brief Frees a spare list of tiles
+ *
+ * @ingroup tiles
+ *
+ * @param[in] tile First tile of the list, chained through chain
+ */
+static void	tile_free_spares(t_tile *tile)
+{
+	t_tile	*next;
+
+	while (tile)
+	{
+		next = tile->chain;
+		free(tile);
+		tile = next;
+	}
+}
+
+/**
+ * @brief Frees every cached tile and the cache tables
+ *
+ * @details Spare tiles are freed too. Closes the persistent store, whose
+ * tiles stay on disk, and leaves the cache empty and disabled, with its
+ * memory cap kept.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] cache Tile cache to release
+ */
+void	tile_cache_free(t_tile_cache *cache)
+{
+	t_tile	*tile;
+	size_t	limit;
+
+	while (cache->head)
+	{
+		tile = cache->head;
+		cache->head = tile->next;
+		free(tile);
+	}
+	tile_free_spares(cache->spare);
+	tile_free_spares(cache->spare_slots);
+	tile_store_close(&cache->store);
+	free(cache->owners);
+	free(cache->buckets);
+	free(cache->grid);
+	free(cache->pending);
+	limit = cache->limit;
+	tile_cache_init(cache, limit);
+}
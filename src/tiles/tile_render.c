@@ -0,0 +1,402 @@
+/**
+ * @file tile_render.c
+ * @brief Composition of views from cached escape count tiles
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Returns the iteration multiplier of a tile level
+ *
+ * @details Applies the zoom-based logarithmic formula of
+ * calculate_iterations() to the zoom a level stands for, 2^(L - TILE_BASE_LEVEL).
+ * Depending on the level only, the cap of a tile never depends on the exact
+ * view that requested it, so tiles can be shared between views.
+ *
+ * @ingroup tiles
+ *
+ * @param[in] level Quadtree level of the tile
+ *
+ * @return double Multiplier applied to the base iteration counts
+ */
+double	tile_level_factor(int level)
+{
+	return (log2(exp2(level - TILE_BASE_LEVEL) + 1));
+}
+
+/**
+ * @brief Returns the accuracy tier a tile of the current formula is keyed by
+ *
+ * @details Formulas whose escape counts do not depend on the tier are keyed
+ * as TIER_EXACT whatever tier computed them, so the window's tile mode,
+ * which renders at TIER_PREVIEW, and the tile server, which renders at
+ * TIER_EXACT, share their tiles in the cache and the persistent store.
+ *
+ * @ingroup tiles
+ *
+ * @param[in] data Pointer to application state with the formula and tier
+ *
+ * @return int Tier stored in the tile key (t_tier)
+ */
+int	tile_key_tier(const t_data *data)
+{
+	if (!fractal_formula(data->type)->tiered)
+		return (TIER_EXACT);
+	return (data->tier);
+}
+
+/**
+ * @brief Returns the index of the sample grid cell holding a coordinate
+ *
+ * @ingroup tiles
+ *
+ * @param[in] coord Real or imaginary coordinate
+ * @param[in] step Sample spacing of the level
+ *
+ * @return long Global sample index along the axis (may be negative)
+ */
+static long	sample_index(double coord, double step)
+{
+	return ((long)floor(coord / step));
+}
+
+/**
+ * @brief Returns the tile coordinate of a global sample index
+ *
+ * @details Floor division by TILE_SIZE, also correct for negative indices.
+ *
+ * @ingroup tiles
+ *
+ * @param[in] sample Global sample index along one axis
+ *
+ * @return long Tile coordinate along the same axis
+ */
+static long	tile_of(long sample)
+{
+	return (sample / TILE_SIZE - (sample % TILE_SIZE < 0));
+}
+
+/**
+ * @brief Computes a square block of escape counts on a level sample grid
+ *
+ * @details Samples are taken at the centre of their grid cell, which is the
+ * point nearest to every pixel that later looks the sample up. Both
+ * renderers working on tiles, the cache and the tile server, go through
+ * this function, so they produce identical escape counts and can share
+ * the persistent store.
+ * The iteration cap must already be fixed through data->iter_factor.
+ *
+ * @ingroup tiles
+ *
+ * @param[in] data Pointer to application state with the fractal parameters
+ * @param[in] level Quadtree level defining the sample spacing
+ * @param[in] origin Global sample indices of the first column and row
+ * @param[in] size Side of the block in samples
+ * @param[out] out size x size escape counts, row-major
+ */
+void	tile_samples(t_data *data, int level, const long *origin, int size,
+			int *out)
+{
+	t_complex	point;
+	double		step;
+	int			i;
+	int			j;
+
+	step = ldexp(TILE_ROOT_SPAN / TILE_SIZE, -level);
+	j = -1;
+	while (++j < size)
+	{
+		point.imag = ((double)(origin[1] + j) + 0.5) * step;
+		i = -1;
+		while (++i < size)
+		{
+			point.real = ((double)(origin[0] + i) + 0.5) * step;
+			out[j * size + i] = fractal_escape(data, point);
+		}
+	}
+}
+
+/**
+ * @brief Thread worker computing the pending tiles of the frame
+ *
+ * @details Tiles are dealt round-robin by thread id rather than in
+ * contiguous runs, so expensive tiles inside the set, which tend to be
+ * neighbours, are spread over all workers.
+ *
+ * @ingroup tiles
+ *
+ * @param[in] arg Pointer to t_thread_data structure containing thread parameters
+ *
+ * @return void* Always returns NULL (required by pthread interface)
+ */
+static void	*tile_compute_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+	t_tile_cache	*cache;
+	long			origin[2];
+	int				i;
+
+	thread_data = (t_thread_data *)arg;
+	cache = &thread_data->data->tiles;
+	i = thread_data->thread_id;
+	while (i < cache->pending_len)
+	{
+		origin[0] = cache->pending[i]->key.tx * TILE_SIZE;
+		origin[1] = cache->pending[i]->key.ty * TILE_SIZE;
+		tile_samples(thread_data->data, cache->level, origin, TILE_SIZE,
+			cache->pending[i]->iters);
+		i += thread_data->data->cpu.threads;
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Finds or allocates one tile of the frame grid
+ *
+ * @details Looks the tile up in memory first, then in the persistent store,
+ * whose samples are used in place. A tile found nowhere gets a store slot,
+ * when one is free, so it is computed straight into the data file, and is
+ * queued as pending.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] cache Tile cache of the frame
+ * @param[in] key Address of the tile
+ * @param[in] i Index of the tile in the frame grid
+ *
+ * @return int Status of the operation
+ * @retval 0 Grid entry filled in
+ * @retval 1 Memory allocation failed
+ */
+static int	grid_tile(t_tile_cache *cache, const t_tile_key *key, int i)
+{
+	int	slot;
+
+	cache->grid[i] = tile_cache_find(cache, key);
+	if (cache->grid[i])
+	{
+		tile_store_touch(&cache->store, cache->grid[i]->slot);
+		cache->hits++;
+		return (0);
+	}
+	slot = tile_store_find(&cache->store, key);
+	if (slot >= 0)
+	{
+		cache->grid[i] = tile_cache_insert(cache, key, slot);
+		cache->loads++;
+		return (!cache->grid[i]);
+	}
+	cache->grid[i] = tile_cache_insert(cache, key,
+			tile_store_reserve(&cache->store, key));
+	if (!cache->grid[i])
+		return (1);
+	cache->pending[cache->pending_len++] = cache->grid[i];
+	cache->misses++;
+	return (0);
+}
+
+/**
+ * @brief Looks up or allocates every tile covering the view
+ *
+ * @details Picks the level whose sample spacing is closest to the pixel
+ * spacing, so a frame costs about as many samples as a direct render, and
+ * fills the grid with the tiles of that level under the screen.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] data Pointer to application state with the tile cache
+ *
+ * @return int Status of the operation
+ * @retval 0 Grid filled in
+ * @retval 1 Memory allocation failed
+ */
+static int	tile_grid(t_data *data)
+{
+	t_tile_cache	*cache;
+	t_tile_key		key;
+	t_complex		corner;
+	int				i;
+
+	cache = &data->tiles;
+	cache->level = (int)lround(log2(TILE_ROOT_SPAN * SCREEN_WIDTH
+				/ (TILE_SIZE * (data->max.real - data->min.real))));
+	if (cache->level < 0)
+		cache->level = 0;
+	cache->step = ldexp(TILE_ROOT_SPAN / TILE_SIZE, -cache->level);
+	corner = screen_to_complex(data, 0, 0);
+	cache->grid_x = tile_of(sample_index(corner.real, cache->step));
+	cache->grid_y = tile_of(sample_index(corner.imag, cache->step));
+	corner = screen_to_complex(data, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1);
+	cache->grid_w = tile_of(sample_index(corner.real, cache->step))
+		- cache->grid_x + 1;
+	cache->grid_h = tile_of(sample_index(corner.imag, cache->step))
+		- cache->grid_y + 1;
+	if (cache->grid_w * cache->grid_h > cache->grid_size)
+	{
+		free(cache->grid);
+		free(cache->pending);
+		cache->grid_size = cache->grid_w * cache->grid_h;
+		cache->grid = (t_tile **)malloc(cache->grid_size * sizeof(t_tile *));
+		cache->pending = (t_tile **)malloc(cache->grid_size * sizeof(t_tile *));
+		if (!cache->grid || !cache->pending)
+			return (1);
+	}
+	key.type = data->type;
+	key.param = data->initial_z;
+	if (fractal_formula(data->type)->julia)
+		key.param = data->initial_c;
+	key.tier = tile_key_tier(data);
+	key.variant = data->step.hash ^ (data->start.hash * 16777619u);
+	key.level = cache->level;
+	cache->pending_len = 0;
+	i = -1;
+	while (++i < cache->grid_w * cache->grid_h)
+	{
+		key.tx = cache->grid_x + i % cache->grid_w;
+		key.ty = cache->grid_y + i / cache->grid_w;
+		if (grid_tile(cache, &key, i))
+			return (1);
+	}
+	return (0);
+}
+
+/**
+ * @brief Makes the tiles covering the current view available
+ *
+ * @details Fixes the iteration cap to the one of the frame level, computes
+ * the tiles missing from the cache and the store on all worker threads,
+ * publishes them in the store and evicts old tiles above the memory cap.
+ * Does nothing while the cache is disabled. On allocation failure the cache
+ * is released and disabled, so the caller falls back to a direct render.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] data Pointer to application state with the tile cache
+ *
+ * @return int Status of the operation
+ * @retval 0 Tiles ready, or cache disabled
+ * @retval 1 Memory allocation failed and the cache was disabled
+ */
+int	tile_fetch(t_data *data)
+{
+	t_thread_data	thread_data[MAX_THREADS];
+	t_tile_cache	*cache;
+	int				i;
+
+	cache = &data->tiles;
+	if (!cache->enabled)
+		return (0);
+	cache->frame++;
+	tile_store_tick(&cache->store);
+	if (tile_grid(data))
+	{
+		print_format("\033[0;91mTile allocation failed, cache disabled\n\033[0;39m");
+		tile_cache_free(cache);
+		data->iter_factor = 0;
+		return (1);
+	}
+	data->iter_factor = tile_level_factor(cache->level);
+	if (cache->pending_len)
+		run_threaded(data, (SDL_Rect){0, 0, 0, 0}, tile_compute_threaded,
+			thread_data);
+	i = -1;
+	while (++i < cache->pending_len)
+		tile_store_commit(&cache->store, cache->pending[i]->slot);
+	tile_cache_trim(cache);
+	return (0);
+}
+
+/**
+ * @brief Thread worker composing a screen section from the frame tiles
+ *
+ * @details Every pixel takes the escape count of the sample nearest to its
+ * complex point, stores it in the iteration buffer and writes its palette
+ * colour. No fractal iteration happens here.
+ *
+ * @ingroup tiles
+ *
+ * @param[in] arg Pointer to t_thread_data structure containing thread parameters
+ *
+ * @return void* Always returns NULL (required by pthread interface)
+ */
+void	*tile_compose_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+	t_tile_cache	*cache;
+	t_vector2		pos;
+	t_complex		point;
+	long			sample[4];
+
+	thread_data = (t_thread_data *)arg;
+	cache = &thread_data->data->tiles;
+	pos.y = thread_data->start_y - 1;
+	while (++pos.y < thread_data->end_y)
+	{
+		pos.x = thread_data->start_x - 1;
+		while (++pos.x < thread_data->end_x)
+		{
+			point = screen_to_complex(thread_data->data, pos.x, pos.y);
+			sample[0] = sample_index(point.real, cache->step);
+			sample[1] = sample_index(point.imag, cache->step);
+			sample[2] = tile_of(sample[0]);
+			sample[3] = tile_of(sample[1]);
+			sample[0] = cache->grid[(sample[3] - cache->grid_y) * cache->grid_w
+				+ sample[2] - cache->grid_x]->iters[(sample[1] - sample[3]
+					* TILE_SIZE) * TILE_SIZE + sample[0] - sample[2] * TILE_SIZE];
+			thread_data->data->iters[pos.y * SCREEN_WIDTH + pos.x] = sample[0];
+			my_mlx_pixel_put(thread_data->data, pos,
+				palette_color(thread_data->data, sample[0]));
+		}
+	}
+	return (NULL);
+}
+
+/**
+ * @brief Enables or disables composing views from the tile cache
+ *
+ * @details Enabling allocates the hash table and opens the persistent store,
+ * falling back to memory only when it is unavailable; disabling reports how
+ * many tiles were reused and releases every cached tile. The view is marked
+ * for redrawing either way, since the iteration cap changes between the two
+ * modes.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] data Pointer to application state with the tile cache
+ */
+void	tile_mode_toggle(t_data *data)
+{
+	t_tile_cache	*cache;
+
+	cache = &data->tiles;
+	if (cache->enabled)
+	{
+		print_format("\033[0;93mTile cache disabled (%d hits, %d loaded, "
+			"%d computed)\n\033[0;39m", (int)cache->hits, (int)cache->loads,
+			(int)cache->misses);
+		tile_cache_free(cache);
+		data->iter_factor = 0;
+	}
+	else
+	{
+		cache->buckets = (t_tile **)calloc(TILE_BUCKETS, sizeof(t_tile *));
+		if (!cache->buckets)
+		{
+			print_format("\033[0;91mTile cache allocation failed\n\033[0;39m");
+			return ;
+		}
+		if (!tile_store_open(&cache->store, TILE_STORE_PATH))
+		{
+			cache->owners = (t_tile **)calloc(cache->store.slots,
+					sizeof(t_tile *));
+			if (!cache->owners)
+				tile_store_close(&cache->store);
+		}
+		cache->enabled = 1;
+		print_format("\033[0;92mTile cache enabled\n\033[0;39m");
+	}
+	data->needs_redraw = 1;
+}
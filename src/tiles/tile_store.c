@@ -0,0 +1,304 @@
+/**
+ * @file tile_store.c
+ * @brief Persistent memory-mapped store of escape count tiles
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Maps one file of the store, resizing it when needed
+ *
+ * @details The file is grown or shrunk to exactly the given size with
+ * ftruncate, which leaves new bytes zeroed and unallocated on disk.
+ *
+ * @ingroup tiles
+ *
+ * @param[in] fd Descriptor of the file, opened for reading and writing
+ * @param[in] bytes Size of the mapping
+ * @param[out] resized Set to 1 when the file did not have that size
+ *
+ * @return void* Shared mapping of the file, or NULL on failure
+ */
+static void	*map_file(int fd, size_t bytes, int *resized)
+{
+	struct stat	info;
+	void		*map;
+
+	if (fstat(fd, &info) < 0)
+		return (NULL);
+	*resized = (size_t)info.st_size != bytes;
+	if (*resized && ftruncate(fd, bytes) < 0)
+		return (NULL);
+	map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED)
+		return (NULL);
+	return (map);
+}
+
+/**
+ * @brief Tells whether a mapped index was created with this configuration
+ *
+ * @ingroup tiles
+ *
+ * @param[in] store Store whose index header is checked
+ *
+ * @return int Boolean result of the check
+ * @retval 1 The stored tiles can be reused
+ * @retval 0 The store must be reset
+ */
+static int	header_matches(t_tile_store *store)
+{
+	t_store_header	*header;
+
+	header = store->header;
+	return (!memcmp(header->magic, "FRACTOL", 8) && header->version == 1
+		&& header->entry_size == sizeof(t_store_entry)
+		&& header->tile_size == TILE_SIZE && header->ways == TILE_STORE_WAYS
+		&& header->iter == ITER && header->base_level == TILE_BASE_LEVEL
+		&& header->slots == store->slots);
+}
+
+/**
+ * @brief Empties the store and writes a header for this configuration
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] store Store with its index mapped
+ */
+static void	reset_index(t_tile_store *store)
+{
+	t_store_header	*header;
+
+	memset(store->header, 0, store->index_bytes);
+	header = store->header;
+	memcpy(header->magic, "FRACTOL", 8);
+	header->version = 1;
+	header->entry_size = sizeof(t_store_entry);
+	header->tile_size = TILE_SIZE;
+	header->ways = TILE_STORE_WAYS;
+	header->iter = ITER;
+	header->base_level = TILE_BASE_LEVEL;
+	header->slots = store->slots;
+	header->clock = 1;
+}
+
+/**
+ * @brief Opens and maps the persistent tile store
+ *
+ * @details Creates path.idx and path.dat if needed and maps both. The index
+ * is locked exclusively, so two processes never write the same store; a
+ * process finding it locked runs on the in-memory cache alone. A store left
+ * by a different configuration is emptied. Nothing is read eagerly: stored
+ * tiles are paged in by the kernel when a frame first touches them.
+ *
+ * @ingroup tiles
+ *
+ * @param[out] store Store to open
+ * @param[in] path Base path of the store files
+ *
+ * @return int Status of the operation
+ * @retval 0 Store open
+ * @retval 1 The store is unavailable (message printed)
+ */
+int	tile_store_open(t_tile_store *store, const char *path)
+{
+	char	name[512];
+	int		resized;
+
+	memset(store, 0, sizeof(t_tile_store));
+	store->slots = ((size_t)TILE_STORE_MB << 20)
+		/ (TILE_SIZE * TILE_SIZE * sizeof(int));
+	store->slots -= store->slots % TILE_STORE_WAYS;
+	store->index_bytes = sizeof(t_store_header)
+		+ store->slots * sizeof(t_store_entry);
+	store->data_bytes = store->slots * TILE_SIZE * TILE_SIZE * sizeof(int);
+	snprintf(name, sizeof(name), "%s.idx", path);
+	store->fd_index = open(name, O_RDWR | O_CREAT, 0644);
+	store->fd_data = -1;
+	if (store->fd_index >= 0 && flock(store->fd_index, LOCK_EX | LOCK_NB) == 0)
+	{
+		snprintf(name, sizeof(name), "%s.dat", path);
+		store->fd_data = open(name, O_RDWR | O_CREAT, 0644);
+		store->header = map_file(store->fd_index, store->index_bytes, &resized);
+	}
+	if (store->header && store->fd_data >= 0)
+	{
+		store->entries = (t_store_entry *)(store->header + 1);
+		if (resized || !header_matches(store))
+			reset_index(store);
+		store->samples = map_file(store->fd_data, store->data_bytes, &resized);
+	}
+	if (store->samples)
+		return (0);
+	print_format("\033[0;93mTile store %s unavailable, using memory only\n"
+		"\033[0;39m", path);
+	tile_store_close(store);
+	return (1);
+}
+
+/**
+ * @brief Unmaps the store and releases its lock
+ *
+ * @details Written slots reach the disk through the shared mappings; the
+ * kernel flushes them even if the process is killed afterwards.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] store Store to close, open or partially opened
+ */
+void	tile_store_close(t_tile_store *store)
+{
+	if (store->samples)
+		munmap(store->samples, store->data_bytes);
+	if (store->header)
+		munmap(store->header, store->index_bytes);
+	if (store->fd_data >= 0)
+		close(store->fd_data);
+	if (store->fd_index >= 0)
+		close(store->fd_index);
+	memset(store, 0, sizeof(t_tile_store));
+	store->fd_index = -1;
+	store->fd_data = -1;
+}
+
+/**
+ * @brief Advances the store clock at the start of a frame
+ *
+ * @details Slots used by the current frame carry the current clock value and
+ * are never chosen for eviction until the next tick.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] store Open or closed store
+ */
+void	tile_store_tick(t_tile_store *store)
+{
+	if (store->header)
+		store->header->clock++;
+}
+
+/**
+ * @brief Looks up a tile in the store
+ *
+ * @details Only the set the key hashes to is searched. A hit refreshes the
+ * slot for the LRU policy.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] store Open or closed store
+ * @param[in] key Address of the tile
+ *
+ * @return int Slot holding the tile, or -1 if it is not stored
+ */
+int	tile_store_find(t_tile_store *store, const t_tile_key *key)
+{
+	size_t	set;
+	int		way;
+
+	if (!store->header)
+		return (-1);
+	set = tile_key_hash(key) % (store->slots / TILE_STORE_WAYS);
+	way = -1;
+	while (++way < TILE_STORE_WAYS)
+	{
+		if (store->entries[set * TILE_STORE_WAYS + way].valid
+			&& tile_key_equal(&store->entries[set * TILE_STORE_WAYS + way].key,
+				key))
+		{
+			tile_store_touch(store, set * TILE_STORE_WAYS + way);
+			return (set * TILE_STORE_WAYS + way);
+		}
+	}
+	return (-1);
+}
+
+/**
+ * @brief Claims a slot to compute a new tile into
+ *
+ * @details Picks a free slot of the tile's set or, when the set is full, its
+ * least recently used slot, whose tile is dropped. Slots used by the current
+ * frame are never taken. The slot stays invalid until tile_store_commit()
+ * is called, so an interrupted render never leaves a half-written tile.
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] store Open or closed store
+ * @param[in] key Address of the tile to store
+ *
+ * @return int Claimed slot, or -1 if the store is closed or the set is busy
+ */
+int	tile_store_reserve(t_tile_store *store, const t_tile_key *key)
+{
+	t_store_entry	*entry;
+	size_t			set;
+	int				best;
+	int				way;
+
+	if (!store->header)
+		return (-1);
+	set = tile_key_hash(key) % (store->slots / TILE_STORE_WAYS);
+	best = -1;
+	way = -1;
+	while (++way < TILE_STORE_WAYS)
+	{
+		entry = &store->entries[set * TILE_STORE_WAYS + way];
+		if (entry->last_use == store->header->clock)
+			continue ;
+		if (best < 0 || !entry->valid
+			|| (store->entries[best].valid
+				&& entry->last_use < store->entries[best].last_use))
+			best = set * TILE_STORE_WAYS + way;
+	}
+	if (best < 0)
+		return (-1);
+	store->entries[best].valid = 0;
+	store->entries[best].key = *key;
+	tile_store_touch(store, best);
+	return (best);
+}
+
+/**
+ * @brief Marks a slot as used by the current frame
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] store Open store
+ * @param[in] slot Slot to refresh, or -1 to do nothing
+ */
+void	tile_store_touch(t_tile_store *store, int slot)
+{
+	if (store->header && slot >= 0)
+		store->entries[slot].last_use = store->header->clock;
+}
+
+/**
+ * @brief Publishes a tile whose samples were fully computed
+ *
+ * @ingroup tiles
+ *
+ * @param[in,out] store Open store
+ * @param[in] slot Slot claimed with tile_store_reserve()
+ */
+void	tile_store_commit(t_tile_store *store, int slot)
+{
+	if (store->header && slot >= 0)
+		store->entries[slot].valid = 1;
+}
+
+/**
+ * @brief Returns the mapped escape counts of a slot
+ *
+ * @ingroup tiles
+ *
+ * @param[in] store Open store
+ * @param[in] slot Slot of the tile
+ *
+ * @return int* TILE_SIZE² escape counts stored in place in the data file
+ */
+int	*tile_store_samples(t_tile_store *store, int slot)
+{
+	return (store->samples + (size_t)slot * TILE_SIZE * TILE_SIZE);
+}
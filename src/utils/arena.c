@@ -0,0 +1,154 @@
+/**
+ * @file arena.c
+ * @brief Frame arenas: aligned bump allocation from large mapped regions
+ *
+ * @details Rendering memory comes from a few regions mapped once at
+ * startup. The buffers arena holds what lives as long as the window (the
+ * escape counts and the frame ring slots) and the scratch arena what lives
+ * for one round of rendering, reset at the start of the next. Every block
+ * starts on an ARENA_ALIGN boundary and every region on an ARENA_PAGE one,
+ * so vector kernels can rely on the alignment of their rows and the kernel
+ * can back the scratch region with huge pages. The buffers region keeps
+ * small pages: a 960x540 escape count buffer fits in one huge page, which
+ * the first worker to touch it would place on its own NUMA node. With the
+ * tile cache recycling its evicted tiles, steady-state rendering never
+ * calls the system allocator; the peaks are reported on exit.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Maps the region of an arena
+ *
+ * @details The size is rounded up to ARENA_PAGE. One extra page is mapped
+ * and the unaligned head and tail are unmapped again, leaving a region
+ * aligned to ARENA_PAGE. With huge set, the region is advised for
+ * transparent huge pages where available; otherwise it is kept on small
+ * pages, even when the system backs every mapping with huge pages.
+ * Anonymous mappings read as zeros and are only backed once written, so on
+ * small pages each worker places the pages of the strip it touches first
+ * on its own NUMA node. A size of 0 gives an empty arena on which every
+ * allocation fails.
+ *
+ * @ingroup utils
+ *
+ * @param[out] arena Arena to set up
+ * @param[in] bytes Least number of bytes the arena must hold
+ * @param[in] huge Back the region with huge pages (0 = small pages only)
+ *
+ * @return int Status of the operation
+ * @retval 0 Arena ready
+ * @retval 1 Mapping failed (the arena is left empty)
+ */
+int	arena_init(t_arena *arena, size_t bytes, int huge)
+{
+	Uint8	*map;
+	size_t	head;
+
+	arena->base = NULL;
+	arena->size = (bytes + ARENA_PAGE - 1) / ARENA_PAGE * ARENA_PAGE;
+	arena->peak = 0;
+	atomic_init(&arena->used, 0);
+	if (!arena->size)
+		return (0);
+	map = (Uint8 *)mmap(NULL, arena->size + ARENA_PAGE,
+			PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (map == MAP_FAILED)
+	{
+		arena->size = 0;
+		return (1);
+	}
+	head = (ARENA_PAGE - (uintptr_t)map % ARENA_PAGE) % ARENA_PAGE;
+	if (head)
+		munmap(map, head);
+	munmap(map + head + arena->size, ARENA_PAGE - head);
+	arena->base = map + head;
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+	if (huge)
+		madvise(arena->base, arena->size, MADV_HUGEPAGE);
+	else
+		madvise(arena->base, arena->size, MADV_NOHUGEPAGE);
+#endif
+	return (0);
+}
+
+/**
+ * @brief Carves an aligned block from an arena
+ *
+ * @details Safe to call from several threads at once. The block stays
+ * valid until the arena is reset or released.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] arena Arena to allocate from
+ * @param[in] bytes Size of the block
+ *
+ * @return void* Block aligned to ARENA_ALIGN, NULL if the arena is full
+ */
+void	*arena_alloc(t_arena *arena, size_t bytes)
+{
+	size_t	offset;
+
+	bytes = (bytes + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+	offset = atomic_fetch_add(&arena->used, bytes);
+	if (offset + bytes > arena->size)
+		return (NULL);
+	return (arena->base + offset);
+}
+
+/**
+ * @brief Hands the whole region of an arena out again
+ *
+ * @details Records the peak first. Must not run while blocks of the arena
+ * are still in use.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] arena Arena to reset
+ */
+void	arena_reset(t_arena *arena)
+{
+	size_t	used;
+
+	used = atomic_exchange(&arena->used, 0);
+	if (used > arena->peak)
+		arena->peak = used;
+}
+
+/**
+ * @brief Prints the peak use of an arena
+ *
+ * @details The current use is folded in first, which resets the arena.
+ * Requests that did not fit are included in the peak, so a peak above the
+ * size shows the arena is too small for the session.
+ *
+ * @ingroup utils
+ *
+ * @param[in] name Name of the arena in the report
+ * @param[in,out] arena Arena to report
+ */
+void	arena_report(const char *name, t_arena *arena)
+{
+	arena_reset(arena);
+	print_format("\033[0;92m%s arena: peak %d KiB of %d KiB\n\033[0;39m",
+		name, (int)(arena->peak >> 10), (int)(arena->size >> 10));
+}
+
+/**
+ * @brief Unmaps the region of an arena
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] arena Arena to release, left empty
+ */
+void	arena_free(t_arena *arena)
+{
+	if (arena->base)
+		munmap(arena->base, arena->size);
+	arena->base = NULL;
+	arena->size = 0;
+	atomic_store(&arena->used, 0);
+}
@@ -120,16 +120,18 @@ static void	hsv_to_rgb(double h, double s, double v, int *out)
  * rotating through the hue spectrum. Higher iteration counts (slower divergence)
  * cycle through different hues. Saturation is kept at maximum for vibrant colors,
  * and value is adjusted to increase brightness with iteration count, creating
- * visually pleasing fractal bands.
+ * visually pleasing fractal bands. The phase rotates the hues, which is how
+ * colour cycling animates HSV-coloured formulas.
  *
  * @ingroup utils
  *
  * @param[in] iter Iteration count when divergence was detected
  * @param[in] max_iter Maximum possible iterations
+ * @param[in] phase Hue rotation in radians (0 for the static colouring)
  *
  * @return int 32-bit ARGB color value for the given iteration count
  */
-int	get_color_hsv(int iter, int max_iter)
+int	get_color_hsv(int iter, int max_iter, double phase)
 {
 	double	t;
 	double	hue;
@@ -138,8 +140,8 @@ int	get_color_hsv(int iter, int max_iter)
 	int		rgb[3];
 
 	t = (double)iter / (max_iter - 1);
-	hue = 360.0 * t + 225;
-	if (hue > 360.0)
+	hue = 360.0 * t + 225 + fmod(phase * 180.0 / PI, 360.0);
+	while (hue > 360.0)
 		hue -= 360.0;
 	sat = 1.0;
 	val = ((double)iter / max_iter) + 0.25;
@@ -190,3 +192,87 @@ int	psychedelic_color(int iter, double phase, int iterations)
 			127.5 * (g_s + 1.0) * envelope,
 			127.5 * (b_s + 1.0) * envelope));
 }
+
+/**
+ * @brief Maps a normalized orbit density to a colour
+ *
+ * @details Dark blue through violet to white: the channels rise with
+ * different powers of the density, so the faint outer orbits stay cool and
+ * the dense core saturates to white.
+ *
+ * @ingroup utils
+ *
+ * @param[in] t Density between 0 and 1
+ *
+ * @return int 32-bit ARGB color value
+ */
+int	density_color(double t)
+{
+	t = fmin(fmax(t, 0.0), 1.0);
+	return (get_trgb(255, 255 * pow(t, 1.4), 255 * pow(t, 2.2),
+			255 * pow(t, 0.7)));
+}
+
+/**
+ * @brief Builds the colour lookup table of the current frame
+ *
+ * @details Within one frame the colour of a pixel depends only on its escape
+ * count, so every possible count from 0 to the iteration cap is shaded once
+ * through fractal_shade. Workers then colour pixels with a table lookup
+ * instead of evaluating the trigonometric colour schemes per pixel, which
+ * also makes recolouring stored escape counts cheap. The table grows when
+ * the iteration cap does and is reused otherwise.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state receiving the palette
+ *
+ * @return int Status of the operation
+ * @retval 0 Palette ready
+ * @retval 1 Allocation failed
+ */
+int	build_palette(t_data *data)
+{
+	Uint32	*palette;
+	int		len;
+	int		i;
+
+	len = iteration_cap(data) + 1;
+	if (len < 1)
+		len = 1;
+	if (len > data->palette_size)
+	{
+		palette = (Uint32 *)realloc(data->palette, len * sizeof(Uint32));
+		if (!palette)
+			return (1);
+		data->palette = palette;
+		data->palette_size = len;
+	}
+	data->palette_len = len;
+	i = -1;
+	while (++i < len)
+		data->palette[i] = (Uint32)fractal_shade(data, i);
+	return (0);
+}
+
+/**
+ * @brief Returns the palette colour of an escape count
+ *
+ * @details Looks the escape count up in the table built by build_palette.
+ * Counts outside the table are clamped to its bounds.
+ *
+ * @ingroup utils
+ *
+ * @param[in] data Pointer to application state with the frame palette
+ * @param[in] dives Escape count returned by fractal_escape
+ *
+ * @return int 32-bit ARGB color for the escape count
+ */
+int	palette_color(t_data *data, int dives)
+{
+	if (dives < 0)
+		dives = 0;
+	else if (dives >= data->palette_len)
+		dives = data->palette_len - 1;
+	return ((int)data->palette[dives]);
+}
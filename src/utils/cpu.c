@@ -0,0 +1,230 @@
+/**
+ * @file cpu.c
+ * @brief Worker thread count detection, pinning and first-touch placement
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#define _GNU_SOURCE
+#include "fract_ol.h"
+#include <sched.h>
+
+/**
+ * @brief Reads a small text file such as a cgroup control file
+ *
+ * @ingroup utils
+ *
+ * @param[in] path File to read
+ * @param[out] buf Null-terminated contents, empty on failure
+ * @param[in] size Size of buf
+ */
+static void	read_small_file(const char *path, char *buf, size_t size)
+{
+	ssize_t	got;
+	int		fd;
+
+	buf[0] = '\0';
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return ;
+	got = read(fd, buf, size - 1);
+	if (got > 0)
+		buf[got] = '\0';
+	close(fd);
+}
+
+/**
+ * @brief Returns the number of CPUs the cgroup CPU quota amounts to
+ *
+ * @details Containers are often limited by a CFS quota rather than by an
+ * affinity mask, so starting one worker per visible CPU would oversubscribe
+ * them. Reads cgroup v2 "cpu.max" ("max 100000" or "<quota> <period>"), or
+ * the cgroup v1 quota and period files, and rounds the quota up.
+ *
+ * @ingroup utils
+ *
+ * @return int CPUs allowed by the quota, or 0 if there is no quota
+ */
+static int	cgroup_cpus(void)
+{
+	char	buf[64];
+	char	*space;
+	long	quota;
+	long	period;
+
+	read_small_file("/sys/fs/cgroup/cpu.max", buf, sizeof(buf));
+	space = str_search_char(buf, ' ');
+	if (space)
+	{
+		quota = str_to_int(buf);
+		period = str_to_int(space + 1);
+	}
+	else
+	{
+		read_small_file("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", buf,
+			sizeof(buf));
+		quota = str_to_int(buf);
+		read_small_file("/sys/fs/cgroup/cpu/cpu.cfs_period_us", buf,
+			sizeof(buf));
+		period = str_to_int(buf);
+	}
+	if (quota <= 0 || period <= 0)
+		return (0);
+	return ((quota + period - 1) / period);
+}
+
+/**
+ * @brief Lists the CPUs of the process affinity mask
+ *
+ * @details The mask reflects taskset and cpuset restrictions. Only Linux
+ * exposes it; elsewhere the caller falls back to the online CPU count.
+ *
+ * @ingroup utils
+ *
+ * @param[out] cpus Up to MAX_THREADS CPU ids, in mask order
+ *
+ * @return int Number of CPUs listed, 0 if the mask is unavailable
+ */
+static int	affinity_cpus(int *cpus)
+{
+	int			count;
+#ifdef __linux__
+	cpu_set_t	set;
+	int			id;
+#endif
+
+	count = 0;
+#ifdef __linux__
+	if (sched_getaffinity(0, sizeof(set), &set))
+		return (0);
+	id = -1;
+	while (++id < CPU_SETSIZE && count < MAX_THREADS)
+		if (CPU_ISSET(id, &set))
+			cpus[count++] = id;
+#else
+	(void)cpus;
+#endif
+	return (count);
+}
+
+/**
+ * @brief Detects how many worker threads to run and on which CPUs
+ *
+ * @details Takes the CPUs of the affinity mask, then lowers the count to the
+ * cgroup CPU quota if one is set. The result is clamped to 1..MAX_THREADS.
+ * Pinning starts disabled.
+ *
+ * @ingroup utils
+ *
+ * @param[out] cpu Detected thread count and CPU list
+ */
+void	cpu_detect(t_cpu *cpu)
+{
+	int	quota;
+	int	i;
+
+	cpu->available = affinity_cpus(cpu->cpus);
+	if (!cpu->available)
+	{
+		cpu->available = fmax(1, fmin(MAX_THREADS,
+					sysconf(_SC_NPROCESSORS_ONLN)));
+		i = -1;
+		while (++i < cpu->available)
+			cpu->cpus[i] = i;
+	}
+	cpu->threads = cpu->available;
+	quota = cgroup_cpus();
+	if (quota > 0 && quota < cpu->threads)
+		cpu->threads = quota;
+	cpu->pin = 0;
+}
+
+/**
+ * @brief Consumes the thread options preceding the fractal name
+ *
+ * @details "-t <n>" overrides the detected worker count and "-p" pins every
+ * worker to one core. Options may appear in any order before the mode or
+ * fractal name.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] cpu Thread settings to override
+ * @param[in] argc Number of command-line arguments
+ * @param[in] argv Command-line arguments
+ *
+ * @return int Number of arguments consumed, or -1 if an option is invalid
+ */
+int	cpu_options(t_cpu *cpu, int argc, char **argv)
+{
+	int	i;
+
+	i = 1;
+	while (i < argc && argv[i][0] == '-')
+	{
+		if (str_compare_all(argv[i], "-p"))
+			cpu->pin = 1;
+		else if (str_compare_all(argv[i], "-t") && i + 1 < argc
+			&& str_to_int(argv[i + 1]) > 0)
+			cpu->threads = fmin(MAX_THREADS, str_to_int(argv[++i]));
+		else
+			return (-1);
+		i++;
+	}
+	return (i - 1);
+}
+
+/**
+ * @brief Prepares the creation attributes of a worker thread
+ *
+ * @details With pinning enabled, worker thread_id is bound to one CPU of the
+ * affinity mask, always the same one. Its memory then comes from that CPU's
+ * NUMA node under the kernel's first-touch policy. The attributes must be
+ * released with pthread_attr_destroy().
+ *
+ * @ingroup utils
+ *
+ * @param[in] cpu Thread settings
+ * @param[out] attr Attributes to initialise
+ * @param[in] thread_id Index of the worker
+ */
+void	cpu_thread_attr(const t_cpu *cpu, pthread_attr_t *attr, int thread_id)
+{
+#ifdef __linux__
+	cpu_set_t	set;
+#endif
+
+	pthread_attr_init(attr);
+	if (!cpu->pin)
+		return ;
+#ifdef __linux__
+	CPU_ZERO(&set);
+	CPU_SET(cpu->cpus[thread_id % cpu->available], &set);
+	pthread_attr_setaffinity_np(attr, sizeof(set), &set);
+#endif
+}
+
+/**
+ * @brief Thread worker writing its strip of the iteration buffer first
+ *
+ * @details Run once on a freshly allocated buffer, before any frame. Linux
+ * places a page on the NUMA node of the CPU that first writes it, so every
+ * pinned worker gets the strip it renders on every full frame on its own
+ * node, without a NUMA library.
+ *
+ * @ingroup utils
+ *
+ * @param[in] arg Pointer to t_thread_data structure with the strip
+ *
+ * @return void* Always returns NULL (required by pthread interface)
+ */
+void	*first_touch_threaded(void *arg)
+{
+	t_thread_data	*thread_data;
+
+	thread_data = (t_thread_data *)arg;
+	memset(thread_data->data->iters + thread_data->start_y * SCREEN_WIDTH,
+		0, (size_t)(thread_data->end_y - thread_data->start_y)
+		* SCREEN_WIDTH * sizeof(int));
+	return (NULL);
+}
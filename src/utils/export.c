@@ -0,0 +1,152 @@
+/**
+ * @file export.c
+ * @brief Anti-aliased image export of the current view and BMP encoding
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Writes a little-endian 32-bit value
+ *
+ * @ingroup utils
+ *
+ * @param[out] out Destination bytes
+ * @param[in] value Value to write
+ */
+void	put_le32(Uint8 *out, Uint32 value)
+{
+	out[0] = value & 0xFF;
+	out[1] = (value >> 8) & 0xFF;
+	out[2] = (value >> 16) & 0xFF;
+	out[3] = value >> 24;
+}
+
+/**
+ * @brief Writes the header of a top-down 32-bit BMP image
+ *
+ * @details Used by the renderers that run without SDL video (tile server,
+ * distributed coordinator). The BMP_HEADER_SIZE bytes written are followed
+ * by width x height pixels stored as little-endian ARGB values, top row
+ * first, which browsers and image viewers read natively.
+ *
+ * @ingroup utils
+ *
+ * @param[out] out BMP_HEADER_SIZE bytes receiving the header
+ * @param[in] width Image width in pixels
+ * @param[in] height Image height in pixels
+ *
+ * @return size_t Total size of the BMP file in bytes
+ */
+size_t	bmp_header(Uint8 *out, int width, int height)
+{
+	size_t	size;
+
+	size = BMP_HEADER_SIZE + (size_t)width * height * 4;
+	memset(out, 0, BMP_HEADER_SIZE);
+	memcpy(out, "BM", 2);
+	put_le32(out + 2, size);
+	put_le32(out + 10, BMP_HEADER_SIZE);
+	put_le32(out + 14, 40);
+	put_le32(out + 18, width);
+	put_le32(out + 22, (Uint32)-height);
+	put_le32(out + 26, 1 | 32 << 16);
+	put_le32(out + 34, size - BMP_HEADER_SIZE);
+	return (size);
+}
+
+/**
+ * @brief Writes an exported frame to disk and shows it on screen
+ *
+ * @details Wraps the buffer in an SDL surface and saves it as a BMP file.
+ * The shown area of the buffer is also copied into the frame ring and
+ * published, so the window shows what was exported; the texture itself
+ * belongs to the event loop, and exports run on the render thread.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state with the frame ring
+ * @param[in] buffer ARGB8888 pixels of the whole screen
+ * @param[in] name Path of the BMP file to write
+ *
+ * @return int Status of the operation
+ * @retval 0 Image written successfully
+ * @retval 1 Surface creation or file writing failed
+ */
+static int	save_frame(t_data *data, Uint32 *buffer, const char *name)
+{
+	SDL_Surface	*surface;
+	int			status;
+	int			y;
+
+	if (!frame_begin(data))
+	{
+		y = -1;
+		while (++y < data->frame.h)
+			mem_copy(data->pixels + y * SCREEN_WIDTH, buffer + (data->frame.y
+					+ y) * SCREEN_WIDTH + data->frame.x,
+				data->frame.w * sizeof(Uint32));
+		frame_end(data);
+	}
+	surface = SDL_CreateRGBSurfaceWithFormatFrom(buffer, SCREEN_WIDTH,
+			SCREEN_HEIGHT, 32, SCREEN_WIDTH * sizeof(Uint32),
+			SDL_PIXELFORMAT_ARGB8888);
+	if (!surface)
+		return (1);
+	status = SDL_SaveBMP(surface, name) < 0;
+	SDL_FreeSurface(surface);
+	return (status);
+}
+
+/**
+ * @brief Saves the current view as an anti-aliased BMP image
+ *
+ * @details Binds a buffer of the scratch arena as render target, re-renders
+ * the view at 1x with the exact transcendental functions, refines it with
+ * adaptive supersampling and writes the result to a
+ * fractol_<ticks>.bmp file in the working directory. Reports how many pixels
+ * needed sub-samples, which is usually a small share of the image. The P key
+ * only sets needs_export; the export runs in a round of the render thread.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ *
+ * @return int Status of the export
+ * @retval 0 Image written successfully
+ * @retval 1 Allocation, surface creation or file writing failed
+ */
+int	export_image(t_data *data)
+{
+	Uint32		*buffer;
+	char		name[64];
+	int			refined;
+	int			supersample;
+
+	buffer = (Uint32 *)arena_alloc(&data->scratch,
+			SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Uint32));
+	if (!buffer)
+		return (1);
+	data->pixels = buffer;
+	data->pitch = SCREEN_WIDTH * sizeof(Uint32);
+	data->frame = (SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+	supersample = data->supersample;
+	data->supersample = 0;
+	data->tier = TIER_EXACT;
+	redraw_fractal(data);
+	refined = supersample_fractal(data);
+	data->tier = TIER_PREVIEW;
+	data->supersample = supersample;
+	data->pixels = NULL;
+	snprintf(name, sizeof(name), "fractol_%u.bmp", SDL_GetTicks());
+	if (save_frame(data, buffer, name))
+	{
+		print_format("\033[0;91mExport failed: %s\n\033[0;39m", SDL_GetError());
+		return (1);
+	}
+	print_format("\033[0;92mSaved %s (%d of %d pixels supersampled)\n\033[0;39m",
+		name, refined, SCREEN_WIDTH * SCREEN_HEIGHT);
+	return (0);
+}
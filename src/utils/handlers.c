@@ -11,10 +11,12 @@
 /**
  * @brief Cleanly shuts down the application and frees all resources
  *
- * @details Destroys the pixel buffer mutex, frees allocated memory, and
- * releases all SDL2 resources including texture, renderer, and window.
- * Calls SDL_Quit to properly shut down SDL subsystems before exiting.
- * This function never returns.
+ * @details Stops the render thread, reports the peak use of the frame
+ * arenas and unmaps them, then frees the palette, the tile cache, the
+ * orbit density histograms and the linked Julia pane, and releases all
+ * SDL2 resources including texture, renderer, and window. Calls SDL_Quit
+ * to properly shut down SDL subsystems before exiting. This function never
+ * returns.
  *
  * @ingroup utils
  *
@@ -24,9 +26,16 @@
  */
 int	close_window(t_data *vars)
 {
-	pthread_mutex_destroy(&vars->pixels_mutex);
-	if (vars->pixels)
-		free(vars->pixels);
+	pipeline_stop(vars);
+	arena_report("Buffers", &vars->buffers);
+	arena_report("Scratch", &vars->scratch);
+	arena_free(&vars->buffers);
+	arena_free(&vars->scratch);
+	if (vars->palette)
+		free(vars->palette);
+	tile_cache_free(&vars->tiles);
+	density_free(&vars->density);
+	split_close(vars);
 	if (vars->texture)
 		SDL_DestroyTexture(vars->texture);
 	if (vars->renderer)
@@ -40,10 +49,18 @@ int	close_window(t_data *vars)
 /**
  * @brief Processes keyboard input events
  *
- * @details Handles keyboard events from SDL2. Currently only implements the
- * ESC key for application termination by calling close_window. Can be extended
- * to handle additional keyboard controls for parameter adjustment, color scheme
- * switching, or view manipulation.
+ * @details Handles keyboard events from SDL2. Keys only change the state
+ * or mark work as pending; the render thread does the rendering.
+ * - ESC terminates the application by calling close_window
+ * - I toggles the time-budgeted adaptive iteration controller
+ * - S toggles adaptive supersampling of the interactive view
+ * - T toggles composing views from the tile cache
+ * - B toggles progressive orbit density (Buddhabrot) images
+ * - J toggles Julia morphing, where the pointer picks the Julia constant
+ * - L toggles the linked view with the Julia set of the c under the pointer
+ * - C toggles continuous colour cycling of the stored escape counts
+ * - P exports the current view as an anti-aliased BMP image
+ * - The arrow keys pan the view by PAN_STEP pixels
  *
  * @ingroup utils
  *
@@ -56,6 +73,33 @@ int	key_handler(SDL_Keycode keycode, t_data *vars)
 {
 	if (keycode == SDLK_ESCAPE)
 		close_window(vars);
+	else if (keycode == SDLK_i)
+		iter_ctrl_toggle(vars);
+	else if (keycode == SDLK_s)
+	{
+		vars->supersample = !vars->supersample;
+		vars->needs_redraw = 1;
+	}
+	else if (keycode == SDLK_t)
+		tile_mode_toggle(vars);
+	else if (keycode == SDLK_b)
+		density_toggle(vars);
+	else if (keycode == SDLK_j)
+		morph_toggle(vars);
+	else if (keycode == SDLK_l)
+		split_toggle(vars);
+	else if (keycode == SDLK_c)
+		cycle_toggle(vars);
+	else if (keycode == SDLK_p)
+		vars->needs_export = 1;
+	else if (keycode == SDLK_LEFT)
+		pan_view(vars, PAN_STEP, 0);
+	else if (keycode == SDLK_RIGHT)
+		pan_view(vars, -PAN_STEP, 0);
+	else if (keycode == SDLK_UP)
+		pan_view(vars, 0, PAN_STEP);
+	else if (keycode == SDLK_DOWN)
+		pan_view(vars, 0, -PAN_STEP);
 	return (0);
 }
 
@@ -66,8 +110,9 @@ int	key_handler(SDL_Keycode keycode, t_data *vars)
  * window. Left mouse button (or wheel up) zooms in by 1.1x, right button
  * (or wheel down) zooms out by 0.9x. The zoom is centered on the cursor's
  * position in the complex plane, maintaining that point's position on screen.
- * Updates viewing bounds, increments color phase for animation, and triggers
- * a complete re-render.
+ * Updates viewing bounds and increments color phase for animation. The view
+ * is only marked for redrawing: the event loop renders once after draining
+ * all pending events, so consecutive zoom steps compose into one transform.
  *
  * @ingroup utils
  *
@@ -109,6 +154,76 @@ int	zoom(Uint8 mousecode, int x, int y, t_data *img)
 	img->max.imag = mouse_point.imag + (img->max.imag - mouse_point.imag) / zoom_factor;
 
 	img->color_off += 0.125;
-	redraw_fractal(img);
+	img->needs_redraw = 1;
+	return (0);
+}
+
+/**
+ * @brief Translates a mouse wheel event into cursor-centered zoom steps
+ *
+ * @details Honours the wheel direction setting (natural scrolling inverts
+ * the sign) and applies one zoom step per wheel notch reported by the event,
+ * so fast flicks that SDL merges into a single event keep their magnitude.
+ * In the linked view, the pane under the cursor is zoomed. The cursor
+ * position is passed in, since a replayed session takes it from its log.
+ * No rendering happens here; see zoom().
+ *
+ * @ingroup utils
+ *
+ * @param[in] wheel SDL mouse wheel event to process
+ * @param[in] mouse Cursor position in the window
+ * @param[in,out] vars Pointer to application state to be updated with new zoom
+ *
+ * @return int Returns 0 after processing the wheel event
+ */
+int	wheel_handler(SDL_MouseWheelEvent *wheel, t_vector2 mouse, t_data *vars)
+{
+	t_data	*target;
+	int		steps;
+	Uint8	button;
+
+	target = split_target(vars, &mouse.x);
+	steps = wheel->y;
+	if (wheel->direction != SDL_MOUSEWHEEL_NORMAL)
+		steps = -steps;
+	button = SDL_BUTTON_LEFT;
+	if (steps < 0)
+		button = SDL_BUTTON_RIGHT;
+	steps = abs(steps);
+	while (steps--)
+		zoom(button, mouse.x, mouse.y, target);
+	return (0);
+}
+
+/**
+ * @brief Moves the view by a whole number of pixels
+ *
+ * @details Shifts min and max by the same complex offset, so the width and
+ * height of the viewing window are preserved and screen pixel (x, y) now
+ * shows what pixel (x - dx, y - dy) showed before. The offset is accumulated
+ * and rendered once per frame by pan_fractal, which only computes the newly
+ * exposed strips.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state to be panned
+ * @param[in] dx Horizontal content offset in pixels (positive moves right)
+ * @param[in] dy Vertical content offset in pixels (positive moves down)
+ *
+ * @return int Returns 0 after processing the pan
+ */
+int	pan_view(t_data *data, int dx, int dy)
+{
+	double	step_real;
+	double	step_imag;
+
+	step_real = (data->max.real - data->min.real) / SCREEN_WIDTH;
+	step_imag = (data->max.imag - data->min.imag) / SCREEN_WIDTH;
+	data->min.real -= dx * step_real;
+	data->max.real -= dx * step_real;
+	data->min.imag -= dy * step_imag;
+	data->max.imag -= dy * step_imag;
+	data->pan_x += dx;
+	data->pan_y += dy;
 	return (0);
 }
@@ -1,6 +1,14 @@
 /**
  * @file img_manag.c
- * @brief Pixel buffer management with thread-safe write operations
+ * @brief Render target management over the triple-buffered frame ring
+ *
+ * @details Frames are rendered into the back slot of a ring of three
+ * full-screen buffers and published with one atomic exchange; the event
+ * loop uploads the area rendered into the newest published frame to the
+ * texture when it presents.
+ * Rendering never touches the texture, so it can run on a thread of its
+ * own while the previous frame is shown, and a frame is never presented
+ * before it is complete.
  *
  * @author Lilith Estévez Boeta
  * @date 2025-11-03
@@ -9,33 +17,155 @@
 #include "fract_ol.h"
 
 /**
- * @brief Thread-safe pixel write to the rendering buffer
+ * @brief Pixel write to the current render target
  *
- * @details Writes a color value to the pixel buffer at the specified screen
- * coordinates. Uses mutex locking to ensure thread safety during multi-threaded
- * rendering. Performs bounds checking to prevent buffer overruns. The pixel
- * buffer is a flat array indexed as (y * width + x) in ARGB8888 format.
+ * @details Writes a color value at the specified screen coordinates into the
+ * render target bound by frame_begin, which maps the screen area data->frame.
+ * Every worker thread writes to its own pixels only, so no locking is needed.
+ * Performs bounds checking against the mapped area to prevent buffer overruns.
  *
  * @ingroup utils
  *
- * @param[in,out] data Pointer to application state containing pixel buffer and mutex
+ * @param[in,out] data Pointer to application state containing the render target
  * @param[in] pos Screen coordinates of the pixel to write
  * @param[in] color 32-bit ARGB color value to write
  *
- * @note Mutex-protected to allow safe concurrent writes from multiple threads
- * @warning Silently ignores writes outside screen bounds
+ * @warning Silently ignores writes outside the mapped area
  */
 void	my_mlx_pixel_put(t_data *data, t_vector2 pos, int color)
 {
-	int	index;
+	Uint32	*row;
+
+	if (pos.x >= data->frame.x && pos.x < data->frame.x + data->frame.w
+		&& pos.y >= data->frame.y && pos.y < data->frame.y + data->frame.h)
+	{
+		row = (Uint32 *)((Uint8 *)data->pixels
+				+ (pos.y - data->frame.y) * data->pitch);
+		row[pos.x - data->frame.x] = (Uint32)color;
+	}
+}
 
-	pthread_mutex_lock(&data->pixels_mutex);
+/**
+ * @brief Carves the slots of a frame ring from an arena
+ *
+ * @details Slot 0 starts as the back slot, 1 as the front slot and 2 as
+ * the ready slot, with no frame published yet and no area rendered into
+ * any slot. The slots live as long as the arena.
+ *
+ * @ingroup utils
+ *
+ * @param[out] ring Frame ring to set up
+ * @param[in,out] arena Arena holding the slots
+ *
+ * @return int Status of the operation
+ * @retval 0 Ring ready
+ * @retval 1 The arena is full
+ */
+int	frame_ring_init(t_frame_ring *ring, t_arena *arena)
+{
+	int	i;
 
-	if (pos.x >= 0 && pos.x < SCREEN_WIDTH && pos.y >= 0 && pos.y < SCREEN_HEIGHT)
+	ring->back = 0;
+	ring->front = 1;
+	atomic_init(&ring->ready, 2);
+	i = -1;
+	while (++i < FRAME_SLOTS)
 	{
-		index = pos.y * SCREEN_WIDTH + pos.x;
-		data->pixels[index] = (Uint32)color;
+		ring->area[i] = (SDL_Rect){0, 0, 0, 0};
+		ring->slot[i] = (Uint32 *)arena_alloc(arena, SCREEN_WIDTH
+				* SCREEN_HEIGHT * sizeof(Uint32));
+		if (!ring->slot[i])
+			return (1);
 	}
+	return (0);
+}
+
+/**
+ * @brief Binds the back slot of the frame ring as the render target
+ *
+ * @details Maps the screen area shown in the window, data->shown, in the
+ * back slot, so workers write straight into the frame that will be
+ * published, each to its own pixels, without locking. Renderers cover the
+ * mapped area only, and only that area is uploaded. When an external
+ * buffer is already bound (image export), it is kept and no slot is bound.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state with the frame ring
+ *
+ * @return int Status of the operation
+ * @retval 0 Render target ready
+ * @retval 1 No frame ring to render into
+ */
+int	frame_begin(t_data *data)
+{
+	t_frame_ring	*ring;
+
+	if (data->pixels)
+		return (0);
+	ring = &data->ring;
+	if (!ring->slot[ring->back])
+		return (1);
+	data->frame = data->shown;
+	data->pitch = SCREEN_WIDTH * sizeof(Uint32);
+	data->pixels = ring->slot[ring->back] + data->frame.y * SCREEN_WIDTH
+		+ data->frame.x;
+	data->bound = 1;
+	return (0);
+}
+
+/**
+ * @brief Releases the render target and publishes the finished frame
+ *
+ * @details Records the screen area rendered into the back slot, then trades
+ * the slot for the ready one in a single atomic exchange that flags the
+ * frame as fresh. A frame the presenter has not taken yet is simply
+ * replaced by the newer one. External buffers bound for exports are left
+ * to their owner.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state with the frame ring
+ */
+void	frame_end(t_data *data)
+{
+	t_frame_ring	*ring;
+
+	if (!data->bound)
+		return ;
+	ring = &data->ring;
+	ring->area[ring->back] = data->frame;
+	ring->back = atomic_exchange(&ring->ready, ring->back | FRAME_FRESH)
+		& ~FRAME_FRESH;
+	data->pixels = NULL;
+	data->bound = 0;
+}
+
+/**
+ * @brief Uploads the newest published frame to the texture
+ *
+ * @details Called by the event loop before presenting. Trades the front
+ * slot for the ready one if it holds a fresh frame; the renderer may be
+ * writing its back slot meanwhile, which is never one of the two. Only the
+ * area rendered into the frame is uploaded, so the texture keeps the rest.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state with the frame ring
+ *
+ * @return int 1 if a new frame was uploaded, 0 otherwise
+ */
+int	frame_acquire(t_data *data)
+{
+	t_frame_ring	*ring;
+	SDL_Rect		*area;
 
-	pthread_mutex_unlock(&data->pixels_mutex);
+	ring = &data->ring;
+	if (!(atomic_load(&ring->ready) & FRAME_FRESH))
+		return (0);
+	ring->front = atomic_exchange(&ring->ready, ring->front) & ~FRAME_FRESH;
+	area = &ring->area[ring->front];
+	SDL_UpdateTexture(data->texture, area, ring->slot[ring->front] + area->y
+		* SCREEN_WIDTH + area->x, SCREEN_WIDTH * sizeof(Uint32));
+	return (1);
 }
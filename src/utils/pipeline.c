@@ -0,0 +1,174 @@
+/**
+ * @file pipeline.c
+ * @brief Render thread decoupling computation from presentation
+ *
+ * @details The event loop hands the pending work of each round to a render
+ * thread and keeps presenting the frames it publishes through the frame
+ * ring. Posting and completing a job is one mutex-guarded wake-up each
+ * way; the frames themselves move between the threads without locks. The
+ * end of a job wakes the event loop, which otherwise sleeps.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Body of the render thread
+ *
+ * @details Sleeps until a job is posted and runs it outside the lock. Its
+ * result and the cleared busy flag hand the application state back to the
+ * event loop, which is woken up.
+ *
+ * @ingroup utils
+ *
+ * @param[in] arg Pointer to the application state
+ *
+ * @return void* Always NULL
+ */
+static void	*pipeline_run(void *arg)
+{
+	t_data		*data;
+	t_pipeline	*pipeline;
+
+	data = (t_data *)arg;
+	pipeline = &data->pipeline;
+	pthread_mutex_lock(&pipeline->lock);
+	while (!pipeline->quit)
+	{
+		if (!pipeline->posted)
+		{
+			pthread_cond_wait(&pipeline->wake, &pipeline->lock);
+			continue ;
+		}
+		pipeline->posted = 0;
+		pthread_mutex_unlock(&pipeline->lock);
+		pipeline->worked = pipeline->job(data);
+		pthread_mutex_lock(&pipeline->lock);
+		atomic_store(&pipeline->busy, 0);
+		pthread_cond_signal(&pipeline->done);
+	}
+	pthread_mutex_unlock(&pipeline->lock);
+	return (NULL);
+}
+
+/**
+ * @brief Starts the render thread
+ *
+ * @details If the thread cannot be created, jobs run in the event loop
+ * itself, as before.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ * @param[in] job Work of one round of the event loop, returning whether it
+ * rendered anything
+ */
+void	pipeline_start(t_data *data, int (*job)(t_data *))
+{
+	t_pipeline	*pipeline;
+
+	pipeline = &data->pipeline;
+	pipeline->job = job;
+	pipeline->worked = 1;
+	pipeline->posted = 0;
+	pipeline->quit = 0;
+	atomic_init(&pipeline->busy, 0);
+	pthread_mutex_init(&pipeline->lock, NULL);
+	pthread_cond_init(&pipeline->wake, NULL);
+	pthread_cond_init(&pipeline->done, NULL);
+	pipeline->started = !pthread_create(&pipeline->thread, NULL,
+			pipeline_run, data);
+	if (!pipeline->started)
+		print_format("\033[0;93mRender thread unavailable, rendering in "
+			"the event loop\n\033[0;39m");
+}
+
+/**
+ * @brief Posts the work of one round to the render thread
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ */
+void	pipeline_post(t_data *data)
+{
+	t_pipeline	*pipeline;
+
+	pipeline = &data->pipeline;
+	if (!pipeline->started)
+	{
+		pipeline->worked = pipeline->job(data);
+		return ;
+	}
+	atomic_store(&pipeline->busy, 1);
+	pthread_mutex_lock(&pipeline->lock);
+	pipeline->posted = 1;
+	pthread_cond_signal(&pipeline->wake);
+	pthread_mutex_unlock(&pipeline->lock);
+}
+
+/**
+ * @brief Tells whether the render thread still owns the application state
+ *
+ * @ingroup utils
+ *
+ * @param[in] data Pointer to application state
+ *
+ * @return int 1 while a posted job has not finished, 0 otherwise
+ */
+int	pipeline_busy(t_data *data)
+{
+	return (atomic_load(&data->pipeline.busy));
+}
+
+/**
+ * @brief Sleeps until the running job ends or a timeout expires
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ * @param[in] ms Longest wait in milliseconds
+ */
+void	pipeline_wait(t_data *data, int ms)
+{
+	t_pipeline		*pipeline;
+	struct timespec	until;
+
+	pipeline = &data->pipeline;
+	clock_gettime(CLOCK_REALTIME, &until);
+	until.tv_nsec += (long)ms * 1000000;
+	until.tv_sec += until.tv_nsec / 1000000000;
+	until.tv_nsec %= 1000000000;
+	pthread_mutex_lock(&pipeline->lock);
+	while (atomic_load(&pipeline->busy)
+		&& !pthread_cond_timedwait(&pipeline->done, &pipeline->lock, &until))
+		;
+	pthread_mutex_unlock(&pipeline->lock);
+}
+
+/**
+ * @brief Waits for the running job and stops the render thread
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ */
+void	pipeline_stop(t_data *data)
+{
+	t_pipeline	*pipeline;
+
+	pipeline = &data->pipeline;
+	if (!pipeline->started)
+		return ;
+	pthread_mutex_lock(&pipeline->lock);
+	pipeline->quit = 1;
+	pthread_cond_signal(&pipeline->wake);
+	pthread_mutex_unlock(&pipeline->lock);
+	pthread_join(pipeline->thread, NULL);
+	pthread_mutex_destroy(&pipeline->lock);
+	pthread_cond_destroy(&pipeline->wake);
+	pthread_cond_destroy(&pipeline->done);
+	pipeline->started = 0;
+}
@@ -0,0 +1,436 @@
+/**
+ * @file session.c
+ * @brief Recording and deterministic replay of interactive sessions
+ *
+ * @details The view state of a window evolves from the input events and
+ * from time: morph refinement, idle iteration refinement and colour
+ * cycling all fire on timers. Both go through the session, which freezes
+ * a clock for every input event and every round of the event loop. A
+ * recording logs the command line, each input event with its tick and
+ * each round that rendered something with the view it left. A replay
+ * feeds the events back through the same handlers with the clock set from
+ * the log and runs each logged round, so the same frames are rendered in
+ * the same order, and prints how long each of them took. The iteration
+ * controller scales its cap with measured render times, so its state is
+ * restored from the log after every round; orbit density passes stay
+ * random and preview cancellations depend on the pointer queue, so those
+ * are reproduced in count but not sample for sample.
+ *
+ * @author Lilith Estévez Boeta
+ * @date 2026-10-18
+ */
+
+#include "fract_ol.h"
+
+/**
+ * @brief Puts a session in its live state: wall clock, no log
+ *
+ * @ingroup utils
+ *
+ * @param[out] session Session to set up
+ */
+void	session_init(t_session *session)
+{
+	memset(session, 0, sizeof(t_session));
+	session->fd = -1;
+	session->now = SDL_GetTicks();
+}
+
+/**
+ * @brief Returns the tick the view state must see
+ *
+ * @details Without a session, as in the tile server, this is the wall
+ * clock.
+ *
+ * @ingroup utils
+ *
+ * @param[in] data Pointer to application state
+ *
+ * @return Uint32 Milliseconds since SDL initialization
+ */
+Uint32	session_ticks(t_data *data)
+{
+	if (!data->session)
+		return (SDL_GetTicks());
+	return (data->session->now);
+}
+
+/**
+ * @brief Advances the session clock to the wall clock
+ *
+ * @details Called before input is applied and before the event loop waits
+ * on timers. A replay keeps the clock of the log.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ */
+void	session_tick(t_data *data)
+{
+	if (data->session && !data->session->replay)
+		data->session->now = SDL_GetTicks();
+}
+
+/**
+ * @brief Starts a round of the event loop
+ *
+ * @details Freezes the clock the render thread will see and marks the
+ * round for session_log_round.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ */
+void	session_round(t_data *data)
+{
+	if (!data->session)
+		return ;
+	session_tick(data);
+	data->session->pending = 1;
+}
+
+/**
+ * @brief Appends a record to the log being recorded
+ *
+ * @details A failed write stops the recording; the session itself goes on.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] session Session being recorded
+ * @param[in] record Record to append
+ */
+static void	session_write(t_session *session, const t_record *record)
+{
+	if (write(session->fd, record, sizeof(t_record)) == sizeof(t_record))
+		return ;
+	print_format("\033[0;91mSession recording failed, stopped\n\033[0;39m");
+	close(session->fd);
+	session->fd = -1;
+}
+
+/**
+ * @brief Starts recording a session
+ *
+ * @details The log starts with SESSION_MAGIC, the number of arguments and
+ * the arguments themselves, NUL-terminated, from the fractal name on.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] session Session to record
+ * @param[in] path File receiving the log, truncated
+ * @param[in] argc Number of arguments naming the fractal
+ * @param[in] argv Fractal name and its parameters
+ *
+ * @return int Status of the operation
+ * @retval 0 Recording
+ * @retval 1 The log cannot be written (message printed)
+ */
+int	session_record(t_session *session, const char *path, int argc,
+		char **argv)
+{
+	Uint32	count;
+	int		status;
+	int		i;
+
+	session->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	count = argc;
+	status = session->fd < 0
+		|| write(session->fd, SESSION_MAGIC, 8) != 8
+		|| write(session->fd, &count, sizeof(count)) != sizeof(count);
+	i = -1;
+	while (!status && ++i < argc)
+		status = write(session->fd, argv[i], str_len(argv[i]) + 1)
+			!= (ssize_t)str_len(argv[i]) + 1;
+	if (!status)
+	{
+		print_format("\033[0;92mRecording the session to %s\n\033[0;39m",
+			path);
+		return (0);
+	}
+	print_format("\033[0;91mCannot record the session to %s\n\033[0;39m",
+		path);
+	if (session->fd >= 0)
+		close(session->fd);
+	session->fd = -1;
+	return (1);
+}
+
+/**
+ * @brief Logs an input event about to be applied
+ *
+ * @details Only the fields the handlers read are kept. Wheel events carry
+ * the pointer position, which the wheel handler reads from SDL rather than
+ * from the event.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ * @param[in] event Input event taken from the SDL queue
+ */
+void	session_log(t_data *data, const SDL_Event *event)
+{
+	t_record	record;
+	t_vector2	mouse;
+
+	if (!data->session || data->session->fd < 0)
+		return ;
+	memset(&record, 0, sizeof(t_record));
+	record.ms = data->session->now;
+	record.type = event->type;
+	if (event->type == SDL_KEYDOWN)
+		record.arg[0] = event->key.keysym.sym;
+	else if (event->type == SDL_MOUSEWHEEL)
+	{
+		mouse = session_mouse(data);
+		record.arg[0] = event->wheel.y;
+		record.arg[1] = event->wheel.direction;
+		record.arg[2] = mouse.x;
+		record.arg[3] = mouse.y;
+	}
+	else if (event->type == SDL_MOUSEMOTION)
+	{
+		record.arg[0] = event->motion.x;
+		record.arg[1] = event->motion.y;
+		record.arg[2] = event->motion.xrel;
+		record.arg[3] = event->motion.yrel;
+		record.arg[4] = event->motion.state;
+	}
+	else
+		return ;
+	session_write(data->session, &record);
+}
+
+/**
+ * @brief Fills the round fields of a record from the application state
+ *
+ * @ingroup utils
+ *
+ * @param[in] data Pointer to application state
+ * @param[out] record Record receiving the view and controller state
+ */
+static void	session_state(t_data *data, t_record *record)
+{
+	record->view[0] = data->min.real;
+	record->view[1] = data->min.imag;
+	record->view[2] = data->max.real;
+	record->view[3] = data->max.imag;
+	record->view[4] = data->zoom_factor;
+	record->view[5] = data->initial_c.real;
+	record->view[6] = data->initial_c.imag;
+	record->ctrl[0] = data->iter_ctrl.scale;
+	record->ctrl[1] = data->iter_ctrl.last_ms;
+}
+
+/**
+ * @brief Logs the round that just ended, if it rendered anything
+ *
+ * @details Called by the event loop once the render thread is done with
+ * the round started by session_round.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ */
+void	session_log_round(t_data *data)
+{
+	t_record	record;
+
+	if (!data->session || !data->session->pending)
+		return ;
+	data->session->pending = 0;
+	if (data->session->fd < 0 || !data->pipeline.worked)
+		return ;
+	memset(&record, 0, sizeof(t_record));
+	record.ms = data->session->now;
+	record.type = SESSION_ROUND;
+	session_state(data, &record);
+	session_write(data->session, &record);
+}
+
+/**
+ * @brief Returns the pointer position for a wheel event
+ *
+ * @ingroup utils
+ *
+ * @param[in] data Pointer to application state
+ *
+ * @return t_vector2 Logged position in a replay, SDL's otherwise
+ */
+t_vector2	session_mouse(t_data *data)
+{
+	t_vector2	mouse;
+
+	if (data->session && data->session->replay)
+		return (data->session->mouse);
+	SDL_GetMouseState(&mouse.x, &mouse.y);
+	return (mouse);
+}
+
+/**
+ * @brief Opens a recorded session for replay
+ *
+ * @details Maps the log and checks its header. The recorded arguments
+ * are exposed in argv form, args[0] holding the log path.
+ *
+ * @ingroup utils
+ *
+ * @param[out] session Session to replay
+ * @param[in] path Recorded log
+ *
+ * @return int Status of the operation
+ * @retval 0 Ready to replay
+ * @retval 1 Unreadable or malformed log (message printed)
+ */
+int	session_load(t_session *session, const char *path)
+{
+	struct stat	info;
+	Uint32		count;
+	Uint8		*end;
+	int			fd;
+
+	session_init(session);
+	session->replay = 1;
+	fd = open(path, O_RDONLY);
+	if (fd >= 0 && !fstat(fd, &info) && info.st_size >= 12)
+	{
+		session->size = info.st_size;
+		session->map = (Uint8 *)mmap(NULL, session->size, PROT_READ,
+				MAP_PRIVATE, fd, 0);
+	}
+	if (fd >= 0)
+		close(fd);
+	if (session->map == MAP_FAILED)
+		session->map = NULL;
+	if (session->map && !memcmp(session->map, SESSION_MAGIC, 8))
+	{
+		memcpy(&count, session->map + 8, sizeof(count));
+		session->next = 12;
+		session->args[0] = (char *)path;
+		session->argc = 1;
+		while (session->argc <= (int)count && session->argc < 4)
+		{
+			end = memchr(session->map + session->next, '\0',
+					session->size - session->next);
+			if (!end)
+				break ;
+			session->args[session->argc++] = (char *)session->map
+				+ session->next;
+			session->next = end - session->map + 1;
+		}
+		if (session->argc == (int)count + 1)
+			return (0);
+	}
+	print_format("\033[0;91mNot a recorded session: %s\n\033[0;39m", path);
+	if (session->map)
+		munmap(session->map, session->size);
+	session->map = NULL;
+	return (1);
+}
+
+/**
+ * @brief Takes the next record of a replayed session
+ *
+ * @details Sets the session clock to the tick of the record. An input
+ * record is also turned back into the SDL event it was logged from.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] session Session being replayed
+ * @param[out] event Event to apply, for input records
+ * @param[out] record Record taken
+ *
+ * @return int 1 if a record was taken, 0 at the end of the log
+ */
+int	session_next(t_session *session, SDL_Event *event, t_record *record)
+{
+	if (session->next + sizeof(t_record) > session->size)
+		return (0);
+	memcpy(record, session->map + session->next, sizeof(t_record));
+	session->next += sizeof(t_record);
+	session->now = record->ms;
+	memset(event, 0, sizeof(SDL_Event));
+	event->type = record->type;
+	if (record->type == SDL_KEYDOWN)
+		event->key.keysym.sym = record->arg[0];
+	else if (record->type == SDL_MOUSEWHEEL)
+	{
+		event->wheel.y = record->arg[0];
+		event->wheel.direction = record->arg[1];
+		session->mouse = (t_vector2){record->arg[2], record->arg[3]};
+	}
+	else if (record->type == SDL_MOUSEMOTION)
+	{
+		event->motion.x = record->arg[0];
+		event->motion.y = record->arg[1];
+		event->motion.xrel = record->arg[2];
+		event->motion.yrel = record->arg[3];
+		event->motion.state = record->arg[4];
+	}
+	return (1);
+}
+
+/**
+ * @brief Reports a replayed round and realigns it with the log
+ *
+ * @details Prints the render time of the round and whether the view it
+ * left matches the logged one bit for bit. The iteration controller state,
+ * which depends on the render times of the recording machine, is then
+ * taken from the log so the following rounds decide as they did.
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] data Pointer to application state
+ * @param[in] record Logged round
+ * @param[in] ms Render time of the replayed round in milliseconds
+ */
+void	session_verify(t_data *data, const t_record *record, double ms)
+{
+	t_session	*session;
+	t_record	replayed;
+	char		text[32];
+	int			same;
+
+	session = data->session;
+	session_state(data, &replayed);
+	same = !memcmp(replayed.view, record->view, sizeof(record->view));
+	data->iter_ctrl.scale = record->ctrl[0];
+	data->iter_ctrl.last_ms = record->ctrl[1];
+	session->frames++;
+	session->total_ms += ms;
+	session->worst_ms = fmax(session->worst_ms, ms);
+	session->diverged += !same;
+	snprintf(text, sizeof(text), "%.3f", ms);
+	if (same)
+		print_format("\033[0;92mframe %d at %d ms: %s ms\n\033[0;39m",
+			session->frames, (int)record->ms, text);
+	else
+		print_format("\033[0;93mframe %d at %d ms: %s ms, view differs from "
+			"the log\n\033[0;39m", session->frames, (int)record->ms, text);
+}
+
+/**
+ * @brief Prints the totals of a replay and releases the log
+ *
+ * @ingroup utils
+ *
+ * @param[in,out] session Replayed session
+ *
+ * @return int 0 if every round left the logged view, 1 otherwise
+ */
+int	session_summary(t_session *session)
+{
+	char	text[96];
+
+	snprintf(text, sizeof(text), "%.1f ms rendering, %.3f ms mean, %.3f ms "
+		"worst", session->total_ms, session->total_ms
+		/ fmax(session->frames, 1), session->worst_ms);
+	print_format("\033[0;92mReplayed %d frames: %s\n\033[0;39m",
+		session->frames, text);
+	if (session->diverged)
+		print_format("\033[0;91m%d frames left a view unlike the log\n"
+			"\033[0;39m", session->diverged);
+	if (session->map)
+		munmap(session->map, session->size);
+	session->map = NULL;
+	return (session->diverged > 0);
+}
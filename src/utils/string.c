@@ -11,8 +11,10 @@
 /**
  * @brief Validates if the input string specifies a Mandelbrot variant
  *
- * @details Checks if the provided string matches any of the supported
- * Mandelbrot-type fractals: "mandelbrot", "sinh", "eye", or "dragon".
+ * @details Checks if the provided string names a registered formula that
+ * iterates from a fixed start with the sample as c, such as "mandelbrot",
+ * "sinh", "eye", or "dragon". User formulas, which also take their source,
+ * are not included.
  * Used during command-line parsing to validate fractal type and determine
  * the expected number of arguments (Mandelbrot types require only the type,
  * while Julia requires additional parameters).
@@ -27,18 +29,17 @@
  */
 int	is_mandelbrot(char *type)
 {
-	if (str_compare_all(type, "mandelbrot")
-		|| str_compare_all(type, "sinh")
-		|| str_compare_all(type, "eye")
-		|| str_compare_all(type, "dragon"))
-		return (1);
-	return (0);
+	const t_formula	*formula;
+
+	formula = formula_by_name(type);
+	return (formula && !formula->julia && !formula->user);
 }
 
 /**
  * @brief Validates if the input string specifies the Julia set fractal
  *
- * @details Checks if the provided string matches "julia". Used during
+ * @details Checks if the provided string names a registered Julia formula,
+ * such as "julia". Used during
  * command-line parsing to identify when Julia set parameters are expected.
  * Julia sets require additional real and imaginary parameters for the
  * constant c, unlike Mandelbrot variants which only need the type name.
@@ -48,12 +49,13 @@ int	is_mandelbrot(char *type)
  * @param[in] type String to validate against Julia set identifier
  *
  * @return int Boolean result of the validation
- * @retval 1 String matches "julia"
- * @retval 0 String does not match "julia"
+ * @retval 1 String names a Julia formula
+ * @retval 0 String does not name a Julia formula
  */
 int	is_julia(char *type)
 {
-	if (str_compare_all(type, "julia"))
-		return (1);
-	return (0);
+	const t_formula	*formula;
+
+	formula = formula_by_name(type);
+	return (formula && formula->julia);
 }